@@ -10,6 +10,7 @@
 
 #include "audio.h"
 #include "../kernel/print.h"
+#include "../kernel/delay.h"
 #include <stdint.h>
 
 #define AUDIO_DEVICE_BASE 0xC0000000   // Hypothetical base address for the audio device
@@ -25,6 +26,8 @@
 #define AUDIO_BIT_DEPTH    16         // 16-bit PCM
 #define AUDIO_CHANNELS     1          // Mono
 
+#define AUDIO_RESET_TIMEOUT_US 100000 // 100 ms
+
 void audio_init(void) {
     print("Loading audio driver...\n");
     // Step 1: Reset the audio device
@@ -35,12 +38,9 @@ void audio_init(void) {
     *audio_ctrl = AUDIO_CTRL_RESET; // Send reset command
 
     // Wait for the reset to complete with a timeout
-    unsigned int timeout = 3000000; // Adjust timeout value as needed
-    while (*audio_status & 0x01) {  // Check if reset bit is set
-        if (--timeout == 0) {
-            print("Audio device not found. Continuing boot without audio driver.\n");
-            return; // Timeout occurred, exit the function
-        }
+    if (poll_until(!(*audio_status & 0x01), AUDIO_RESET_TIMEOUT_US)) {  // Check if reset bit is set
+        print("Audio device not found. Continuing boot without audio driver.\n");
+        return; // Timeout occurred, exit the function
     }
 
     // Step 2: Configure the audio device
@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * drivers/console.c
+ *
+ * VGA text console with scrollback.
+ *
+ * Copyright (C) 2024-2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "console.h"
+#include "shadow.h"
+#include "../kernel/io.h"
+#include "../kernel/print.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/time.h"
+#include "../kernel/timer.h"
+
+#define VGA_TEXT_ADDR   0xB8000
+#define VGA_TEXT_CELLS  16384  // The whole 32 KiB window, not just one screen
+
+#define VGA_CRTC_INDEX  0x3D4
+#define VGA_CRTC_DATA   0x3D5
+#define CRTC_START_HI   0x0C
+#define CRTC_START_LO   0x0D
+#define CRTC_CURSOR_HI  0x0E
+#define CRTC_CURSOR_LO  0x0F
+
+#define SCREEN_CELLS (CONSOLE_ROWS * CONSOLE_COLS)
+#define BLANK        ((uint16_t)((CONSOLE_ATTR << 8) | ' '))
+
+static volatile uint16_t *const vram = (volatile uint16_t *)VGA_TEXT_ADDR;
+
+/*
+ * Every line ever printed has a number, line n lives in
+ * scrollback[n % CONSOLE_SCROLLBACK]. The live screen shows lines
+ * top_row to top_row + 24, drawn in VRAM starting at cell vram_top.
+ * Scrolling moves vram_top down a row and points the CRTC at it, the
+ * screen is only copied when we run off the end of VRAM.
+ *
+ * Output only goes into the scrollback, which doubles as the shadow of
+ * the screen. What changed since the last flush is kept as a rectangle
+ * of screen cells, and console_flush() copies just that out to VRAM.
+ */
+static uint16_t scrollback[CONSOLE_SCROLLBACK][CONSOLE_COLS];
+static uint32_t top_row;
+static uint32_t cur_row;
+static uint32_t cur_col;
+static uint32_t vram_top;
+static uint32_t view_back;  // Lines scrolled back, 0 when live
+
+static struct dirty_rect dirty;  // Screen cells VRAM doesn't have yet
+static int origin_dirty;
+static int cursor_dirty;
+static int suspended;            // Graphics mode owns the display
+
+static DEFINE_SPINLOCK(console_lock);
+static struct timer_list console_timer;
+
+static inline uint16_t *line(uint32_t row) {
+    return scrollback[row & (CONSOLE_SCROLLBACK - 1)];
+}
+
+static void crtc_write(uint8_t reg, uint8_t value) {
+    outb(VGA_CRTC_INDEX, reg);
+    outb(VGA_CRTC_DATA, value);
+}
+
+static void console_set_origin(void) {
+    crtc_write(CRTC_START_HI, vram_top >> 8);
+    crtc_write(CRTC_START_LO, vram_top & 0xFF);
+    origin_dirty = 0;
+}
+
+static void blank_line(uint16_t *cells) {
+    for (int i = 0; i < CONSOLE_COLS; i++) {
+        cells[i] = BLANK;
+    }
+}
+
+static void dirty_screen(void) {
+    dirty_add(&dirty, 0, 0, CONSOLE_COLS, CONSOLE_ROWS);
+}
+
+// The rows already in VRAM move up with the origin, so does what's owed
+static void dirty_scroll(void) {
+    if (!dirty_empty(&dirty)) {
+        dirty.y0 = dirty.y0 > 0 ? dirty.y0 - 1 : 0;
+        dirty.y1--;
+        if (dirty_empty(&dirty)) {
+            dirty_reset(&dirty);
+        }
+    }
+}
+
+// Back to live output if someone was looking at the scrollback
+static void console_unview(void) {
+    if (view_back) {
+        view_back = 0;
+        dirty_screen();
+        cursor_dirty = 1;
+    }
+}
+
+static void console_newline(void) {
+    int row;
+
+    cur_col = 0;
+    cur_row++;
+    blank_line(line(cur_row));
+
+    if (cur_row - top_row >= CONSOLE_ROWS) {
+        top_row++;
+        vram_top += CONSOLE_COLS;
+        origin_dirty = 1;
+
+        if (vram_top + SCREEN_CELLS > VGA_TEXT_CELLS) {
+            // Off the end of VRAM, redraw at the top. Once every 179 lines.
+            vram_top = 0;
+            dirty_screen();
+        } else {
+            dirty_scroll();
+        }
+    }
+
+    row = cur_row - top_row;
+    dirty_add(&dirty, 0, row, CONSOLE_COLS, row + 1);
+}
+
+static void console_putc(char c) {
+    uint16_t cell;
+    int row;
+
+    switch (c) {
+        case '\n':
+            console_newline();
+            return;
+        case '\b':  // Handle backspace
+            if (cur_col == 0) {
+                return;
+            }
+            cur_col--;
+            cell = BLANK;
+            break;
+        default:
+            cell = (CONSOLE_ATTR << 8) | (uint8_t)c;
+            break;
+    }
+
+    line(cur_row)[cur_col] = cell;
+    row = cur_row - top_row;
+    dirty_add(&dirty, cur_col, row, cur_col + 1, row + 1);
+
+    if (c != '\b' && ++cur_col >= CONSOLE_COLS) {
+        console_newline();
+    }
+}
+
+void console_write(const char *buf, size_t len) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&console_lock, flags);
+
+    console_unview();
+    for (size_t i = 0; i < len; i++) {
+        console_putc(buf[i]);
+    }
+    cursor_dirty = 1;
+
+    spin_unlock_irqrestore(&console_lock, flags);
+}
+
+// Fresh page, what was on screen stays in the scrollback
+void console_clear(void) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&console_lock, flags);
+
+    console_unview();
+
+    vram_top += (cur_row - top_row + 1) * CONSOLE_COLS;
+    if (vram_top + SCREEN_CELLS > VGA_TEXT_CELLS) {
+        vram_top = 0;
+    }
+
+    top_row = cur_row + 1;
+    cur_row = top_row;
+    cur_col = 0;
+
+    for (int r = 0; r < CONSOLE_ROWS; r++) {
+        blank_line(line(top_row + r));
+    }
+
+    dirty_screen();
+    origin_dirty = 1;
+    cursor_dirty = 1;
+
+    spin_unlock_irqrestore(&console_lock, flags);
+}
+
+/*
+ * Rows of the dirty rectangle go out as dword copies, widened to even
+ * cells so both ends are aligned. Rows are 160 bytes, so every one
+ * starts aligned too.
+ */
+static void console_draw_dirty(void) {
+    uint32_t first = top_row - view_back;
+    int x0 = dirty.x0 & ~1;
+    int x1 = (dirty.x1 + 1) & ~1;
+
+    for (int r = dirty.y0; r < dirty.y1; r++) {
+        vram_copy(&vram[vram_top + r * CONSOLE_COLS + x0], &line(first + r)[x0],
+                  (x1 - x0) * sizeof(uint16_t));
+    }
+
+    dirty_reset(&dirty);
+}
+
+void console_flush(void) {
+    uint32_t flags, pos;
+
+    spin_lock_irqsave(&console_lock, flags);
+
+    if (suspended) {
+        spin_unlock_irqrestore(&console_lock, flags);
+        return;
+    }
+
+    if (!dirty_empty(&dirty)) {
+        console_draw_dirty();
+    }
+
+    // Only after the rows are there, or the screen shows them half drawn
+    if (origin_dirty) {
+        console_set_origin();
+    }
+
+    if (cursor_dirty) {
+        // Parked just below the screen while looking back, which hides it
+        if (view_back) {
+            pos = vram_top + SCREEN_CELLS;
+        } else {
+            pos = vram_top + (cur_row - top_row) * CONSOLE_COLS + cur_col;
+        }
+
+        crtc_write(CRTC_CURSOR_HI, pos >> 8);
+        crtc_write(CRTC_CURSOR_LO, pos & 0xFF);
+        cursor_dirty = 0;
+    }
+
+    spin_unlock_irqrestore(&console_lock, flags);
+}
+
+void console_scroll(int lines) {
+    uint32_t max, back, flags;
+
+    spin_lock_irqsave(&console_lock, flags);
+
+    // Can't go back past line 0, or further than the lines we still have
+    max = top_row < CONSOLE_SCROLLBACK - CONSOLE_ROWS ? top_row : CONSOLE_SCROLLBACK - CONSOLE_ROWS;
+
+    if (lines == 0) {
+        back = 0;
+    } else if (lines < 0) {
+        back = view_back + (uint32_t)-lines > max ? max : view_back + (uint32_t)-lines;
+    } else {
+        back = (uint32_t)lines > view_back ? 0 : view_back - lines;
+    }
+
+    if (back != view_back) {
+        view_back = back;
+        dirty_screen();
+        cursor_dirty = 1;
+    }
+
+    spin_unlock_irqrestore(&console_lock, flags);
+}
+
+static void console_timer_fn(struct timer_list *timer) {
+    console_flush();
+    mod_timer(timer, jiffies + msecs_to_jiffies(CONSOLE_FLUSH_MS));
+}
+
+void console_timer_init(void) {
+    timer_setup(&console_timer, console_timer_fn);
+    mod_timer(&console_timer, jiffies + msecs_to_jiffies(CONSOLE_FLUSH_MS));
+}
+
+void console_init(void) {
+    for (int r = 0; r < CONSOLE_ROWS; r++) {
+        blank_line(line(r));
+    }
+
+    dirty_reset(&dirty);
+    dirty_screen();
+    origin_dirty = 1;
+    cursor_dirty = 1;
+    console_flush();
+}
+
+// Output still lands in the scrollback, it just isn't shown
+void console_suspend(void) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&console_lock, flags);
+    suspended = 1;
+    spin_unlock_irqrestore(&console_lock, flags);
+}
+
+void print(const char *str) {
+    size_t len = 0;
+
+    while (str[len]) {
+        len++;
+    }
+    console_write(str, len);
+}
+
+void print_char(char c) {
+    console_write(&c, 1);
+}
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stddef.h>
+
+#define CONSOLE_COLS       80
+#define CONSOLE_ROWS       25
+#define CONSOLE_SCROLLBACK 4096  // Lines kept in RAM, a power of two
+#define CONSOLE_ATTR       0x07  // Light grey on black
+#define CONSOLE_FLUSH_MS   20    // Longest the screen lags behind output
+
+void console_init(void);
+void console_timer_init(void);  // Once timers work
+
+void console_write(const char *buf, size_t len);
+void console_clear(void);
+
+// Copy what changed out to VRAM, then move the origin and cursor
+void console_flush(void);
+
+// Hand the display over to graphics mode, there's no way back to text yet
+void console_suspend(void);
+
+// Look back through the scrollback, negative goes further back, 0 returns to live
+void console_scroll(int lines);
+
+#endif // CONSOLE_H
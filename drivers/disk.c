@@ -9,43 +9,47 @@
  */
 
 #include "../kernel/io.h"
+#include "../kernel/delay.h"
 #include "disk.h"
 
 void ata_pio_select_drive(uint8_t drive) {
     outb(ATA_REG_DRIVE_SELECT, 0xA0 | (drive << 4));
 }
 
-void ata_pio_wait_ready() {
-    uint8_t status;
-    // Read 15 times and pay attention to the last
-    for (int i = 0; i < 15; i++) {
-        status = inb(ATA_REG_STATUS);
-    }
-    
+int ata_pio_wait_ready() {
+    // Status isn't valid for 400ns after a drive select or a command
+    ndelay(400);
+
     // Ensure the drive is not busy and is ready
-    while (status & ATA_STATUS_BUSY) {
-        status = inb(ATA_REG_STATUS);
-    }
+    return poll_until(!(inb(ATA_REG_STATUS) & ATA_STATUS_BUSY), ATA_BUSY_TIMEOUT_US);
 }
 
-void ata_pio_init() {
+// The drive raises DRQ once it has data for us or wants data from us
+static int ata_pio_wait_drq(void) {
+    return poll_until(inb(ATA_REG_STATUS) & (ATA_STATUS_DRQ | ATA_STATUS_ERROR), ATA_DRQ_TIMEOUT_US);
+}
+
+int ata_pio_init() {
     outb(0x3F6, 0);    
 
     // Select the primary master drive
     ata_pio_select_drive(0);
 
     // Send IDENTIFY command to the drive
-    ata_pio_wait_ready();
+    if (ata_pio_wait_ready()) {
+        return -1; // Error: No drive, or it never came out of busy
+    }
     outb(ATA_REG_COMMAND, ATA_COMMAND_IDENTIFY);
 
     // Wait for the drive to be ready
-    ata_pio_wait_ready();
-
+    return ata_pio_wait_ready();
 }
 
 int ata_pio_read(uint32_t lba, void *buffer, size_t size) {
     uint16_t *buf = (uint16_t *)buffer;  // Use 16-bit buffer for 16-bit reads
-    ata_pio_wait_ready();
+    if (ata_pio_wait_ready()) {
+        return -1; // Error: Disk not ready for read
+    }
     ata_pio_select_drive(0);  // Select primary master drive
 
     // Setup LBA address
@@ -56,7 +60,7 @@ int ata_pio_read(uint32_t lba, void *buffer, size_t size) {
     outb(ATA_REG_COMMAND, ATA_COMMAND_READ_SECTORS);
 
     // Wait for the drive to signal it's ready for data transfer
-    if (!(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
+    if (ata_pio_wait_ready() || ata_pio_wait_drq() || !(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
         return -1; // Error: Disk not ready for read
     }
 
@@ -74,7 +78,9 @@ int ata_pio_read(uint32_t lba, void *buffer, size_t size) {
 
 int ata_pio_write(uint32_t lba, const void *buffer, size_t size) {
     const uint16_t *buf = (const uint16_t *)buffer;
-    ata_pio_wait_ready();
+    if (ata_pio_wait_ready()) {
+        return -3; // Error: Disk not ready for write
+    }
     ata_pio_select_drive(0); // Select primary master drive
 
     // Setup LBA address
@@ -85,7 +91,7 @@ int ata_pio_write(uint32_t lba, const void *buffer, size_t size) {
     outb(ATA_REG_COMMAND, ATA_COMMAND_WRITE_SECTORS);
 
     // Wait until the drive is ready for data transfer
-    if (!(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
+    if (ata_pio_wait_ready() || ata_pio_wait_drq() || !(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
         return -3; // Error: Disk not ready for write
     }
 
@@ -100,10 +106,9 @@ int ata_pio_write(uint32_t lba, const void *buffer, size_t size) {
 
     // Send the flush command to ensure the data is written
     outb(ATA_REG_COMMAND, ATA_COMMAND_CACHE_FLUSH);
-    ata_pio_wait_ready();
 
     // Check if flush command succeeded
-    if (!(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
+    if (ata_pio_wait_ready() || !(inb(ATA_REG_STATUS) & ATA_STATUS_DRQ)) {
         return -5; // Error: Disk write flush failed
     }
 
@@ -24,6 +24,10 @@
 #define ATA_COMMAND_WRITE_SECTORS   0x30
 #define ATA_COMMAND_CACHE_FLUSH    0xE7
 
+// Timeouts
+#define ATA_BUSY_TIMEOUT_US   1000000  // Spin-up can take a while
+#define ATA_DRQ_TIMEOUT_US    100000
+
 // ATA Status Register Bits
 #define ATA_STATUS_BUSY       0x80
 #define ATA_STATUS_DRQ        0x08
@@ -32,9 +36,9 @@
 
 // Function prototypes
 void ata_pio_select_drive(uint8_t drive);
-void ata_pio_wait_ready(void);
+int ata_pio_wait_ready(void);  // 0 when ready, -1 if the drive stays busy
 int ata_pio_read(uint32_t lba, void *buffer, size_t size);
 int ata_pio_write(uint32_t lba, const void *buffer, size_t size);
-void ata_pio_init();
+int ata_pio_init(void);  // 0 once the drive answers IDENTIFY, -1 on timeout
 
 #endif // DISK_H
@@ -9,40 +9,115 @@
  */
 
 #include <stdint.h>
+#include "graphics.h"
+#include "shadow.h"
 #include "../kernel/print.h"
 #include "../kernel/abs.h"
+#include "../kernel/boottime.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/time.h"
+#include "../kernel/timer.h"
 
-#define FRAMEBUFFER_ADDR 0xA000
+#define FRAMEBUFFER_ADDR 0xA0000
 #define SCREEN_WIDTH  320
 #define SCREEN_HEIGHT 200
 
+/*
+ * Everything is drawn into shadow_fb. The part that changed goes out to
+ * the real framebuffer on graphics_flush(), which also runs every
+ * GRAPHICS_FLUSH_MS once mode 13h is up. Before that there's nothing
+ * to flush to, 0xA0000 isn't mapped in text mode.
+ */
+static uint8_t shadow_fb[SCREEN_HEIGHT][SCREEN_WIDTH] __attribute__((aligned(4)));
+static struct dirty_rect dirty;
+static int graphics_active;
+static DEFINE_SPINLOCK(graphics_lock);
+static struct timer_list graphics_timer;
+
 void init_graphics() {
-    print("Loading advanced framebuffer driver...\n");
-    uint8_t *framebuffer = (uint8_t *)FRAMEBUFFER_ADDR;
-    print("Advanced framebuffer driver loaded.");
-    for (int y = 0; y < SCREEN_HEIGHT; ++y) {
-        for (int x = 0; x < SCREEN_WIDTH; ++x) {
-            framebuffer[y * SCREEN_WIDTH + x] = 0x0F;
+    boot_print("Loading advanced framebuffer driver...\n");
+    boot_print("Advanced framebuffer driver loaded.\n");
+    dirty_reset(&dirty);
+    fill_screen(0x0F);
+}
+
+// Rows go out as dword copies, the rectangle is widened to 4 pixel boundaries for it
+void graphics_flush(void) {
+    volatile uint8_t *framebuffer = (volatile uint8_t *)FRAMEBUFFER_ADDR;
+    uint32_t flags;
+    int x0, x1;
+
+    spin_lock_irqsave(&graphics_lock, flags);
+
+    if (graphics_active && !dirty_empty(&dirty)) {
+        x0 = dirty.x0 & ~3;
+        x1 = (dirty.x1 + 3) & ~3;
+
+        for (int y = dirty.y0; y < dirty.y1; y++) {
+            vram_copy(&framebuffer[y * SCREEN_WIDTH + x0], &shadow_fb[y][x0], x1 - x0);
         }
+        dirty_reset(&dirty);
+    }
+
+    spin_unlock_irqrestore(&graphics_lock, flags);
+}
+
+static void graphics_timer_fn(struct timer_list *timer) {
+    graphics_flush();
+    mod_timer(timer, jiffies + msecs_to_jiffies(GRAPHICS_FLUSH_MS));
+}
+
+// Mode 13h is set, the framebuffer is ours from here
+void graphics_enable(void) {
+    uint32_t flags;
+    int was_active;
+
+    spin_lock_irqsave(&graphics_lock, flags);
+    was_active = graphics_active;
+    graphics_active = 1;
+    dirty_add(&dirty, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+    spin_unlock_irqrestore(&graphics_lock, flags);
+
+    graphics_flush();
+
+    if (!was_active) {
+        timer_setup(&graphics_timer, graphics_timer_fn);
+        mod_timer(&graphics_timer, jiffies + msecs_to_jiffies(GRAPHICS_FLUSH_MS));
     }
 }
 
-// Helper function to set a pixel
+// Helper function to set a pixel, with graphics_lock held
 static void set_pixel(int x, int y, uint8_t color) {
     if (x >= 0 && x < SCREEN_WIDTH && y >= 0 && y < SCREEN_HEIGHT) {
-        uint8_t *framebuffer = (uint8_t *)FRAMEBUFFER_ADDR;
-        framebuffer[y * SCREEN_WIDTH + x] = color;
+        shadow_fb[y][x] = color;
+        dirty_add(&dirty, x, y, x + 1, y + 1);
     }
 }
 
-
-// Draw a rectangle
+// Draw a rectangle, clipped to the screen
 void draw_rectangle(int x, int y, int width, int height, uint8_t color) {
-    for (int i = y; i < y + height; ++i) {
-        for (int j = x; j < x + width; ++j) {
-            set_pixel(j, i, color);
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + width > SCREEN_WIDTH ? SCREEN_WIDTH : x + width;
+    int y1 = y + height > SCREEN_HEIGHT ? SCREEN_HEIGHT : y + height;
+    uint32_t flags;
+
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    spin_lock_irqsave(&graphics_lock, flags);
+    for (int i = y0; i < y1; ++i) {
+        for (int j = x0; j < x1; ++j) {
+            shadow_fb[i][j] = color;
         }
     }
+    dirty_add(&dirty, x0, y0, x1, y1);
+    spin_unlock_irqrestore(&graphics_lock, flags);
+}
+
+void fill_screen(uint8_t color) {
+    draw_rectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, color);
 }
 
 // Draw a line (Bresenham's line algorithm)
@@ -52,7 +127,9 @@ void draw_line(int x1, int y1, int x2, int y2, uint8_t color) {
     int sx = x1 < x2 ? 1 : -1;
     int sy = y1 < y2 ? 1 : -1;
     int err = dx - dy;
+    uint32_t flags;
 
+    spin_lock_irqsave(&graphics_lock, flags);
     while (1) {
         set_pixel(x1, y1, color);
         if (x1 == x2 && y1 == y2) break;
@@ -60,6 +137,7 @@ void draw_line(int x1, int y1, int x2, int y2, uint8_t color) {
         if (e2 > -dy) { err -= dy; x1 += sx; }
         if (e2 < dx) { err += dx; y1 += sy; }
     }
+    spin_unlock_irqrestore(&graphics_lock, flags);
 }
 
 static const uint8_t font[128][8] = {
@@ -259,6 +337,9 @@ static const uint8_t font[128][8] = {
 void draw_char(int x, int y, char ch, uint8_t color) {
     if (ch < 32 || ch > 127) return; // Handle out-of-bounds characters
     const uint8_t *bitmap = font[ch - 32];
+    uint32_t flags;
+
+    spin_lock_irqsave(&graphics_lock, flags);
     for (int i = 0; i < 8; ++i) {
         for (int j = 0; j < 8; ++j) {
             if (bitmap[i] & (1 << (7 - j))) {
@@ -266,6 +347,7 @@ void draw_char(int x, int y, char ch, uint8_t color) {
             }
         }
     }
+    spin_unlock_irqrestore(&graphics_lock, flags);
 }
 
 
@@ -5,13 +5,14 @@
 
 #include <stdint.h>
 
+#define GRAPHICS_FLUSH_MS 20  // Longest drawing waits to reach the screen
+
 // Function prototypes
 void init_graphics(void);
-static void set_pixel(int x, int y, uint8_t color);
+void graphics_enable(void);
+void graphics_flush(void);
+void fill_screen(uint8_t color);
 void draw_rectangle(int x, int y, int width, int height, uint8_t color);
 void draw_line(int x1, int y1, int x2, int y2, uint8_t color);
 
-// Helper function for setting a pixel, used internally
-static void set_pixel(int x, int y, uint8_t color);
-
 #endif // GRAPHICS_H
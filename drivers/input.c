@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * drivers/input.c
+ *
+ * Input event queue and /dev/input.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "input.h"
+#include "../fs/devfs/devfs.h"
+#include "../fs/vfs/vfs.h"
+#include "../kernel/kfifo.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/wait.h"
+
+// Producers serialise on input_lock, the reader doesn't need it
+DEFINE_KFIFO(input_ring, INPUT_RING_SIZE);
+static DEFINE_SPINLOCK(input_lock);
+
+static int input_overflowed;    // Owe the reader a SYN_DROPPED
+static uint32_t input_nr_dropped;
+static volatile int input_open;  // One reader, events aren't shared out
+
+void input_event(uint64_t tsc, uint16_t type, uint16_t code, int32_t value) {
+    struct input_event ev = { .tsc = tsc, .type = type, .code = code, .value = value };
+    uint32_t flags;
+
+    if (!input_open) {
+        return;  // Nobody to deliver to
+    }
+
+    spin_lock_irqsave(&input_lock, flags);
+
+    if (input_overflowed) {
+        struct input_event dropped = { .tsc = tsc, .type = EV_SYN, .code = SYN_DROPPED };
+
+        if (kfifo_avail(&input_ring) >= 2 * sizeof(ev)) {
+            kfifo_in(&input_ring, &dropped, sizeof(dropped));
+            input_overflowed = 0;
+        }
+    }
+
+    if (input_overflowed || !kfifo_in(&input_ring, &ev, sizeof(ev))) {
+        input_overflowed = 1;
+        input_nr_dropped++;
+    }
+
+    spin_unlock_irqrestore(&input_lock, flags);
+}
+
+uint32_t input_dropped(void) {
+    return input_nr_dropped;
+}
+
+static int input_dev_open(int flags) {
+    uint32_t lock_flags;
+    int ret = 0;
+
+    spin_lock_irqsave(&input_lock, lock_flags);
+    if (input_open) {
+        ret = -1;
+    } else {
+        // Start with a clean queue, not whatever came before
+        input_ring.out = input_ring.in;
+        input_overflowed = 0;
+        input_open = 1;
+    }
+    spin_unlock_irqrestore(&input_lock, lock_flags);
+
+    return ret;
+}
+
+static void input_dev_release(void) {
+    input_open = 0;
+}
+
+// Whole events only, as many as fit. Blocks for the first unless O_NONBLOCK.
+static ssize_t input_dev_read(void *buf, size_t size, int flags) {
+    struct input_event *events = buf;
+    size_t count = 0, max = size / sizeof(struct input_event);
+
+    if (max == 0) {
+        return -1;
+    }
+
+    if (!(flags & O_NONBLOCK)) {
+        wait_event(kfifo_len(&input_ring) >= sizeof(struct input_event));
+    }
+
+    while (count < max && kfifo_out(&input_ring, &events[count], sizeof(struct input_event))) {
+        count++;
+    }
+
+    return count * sizeof(struct input_event);
+}
+
+static struct device input_device = {
+    .path = "/dev/input",
+    .open = input_dev_open,
+    .read = input_dev_read,
+    .release = input_dev_release,
+};
+
+void input_init(void) {
+    devfs_register(&input_device);
+}
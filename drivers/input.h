@@ -0,0 +1,75 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+/*
+ * Keyboard and mouse events, read in batches from /dev/input. Types
+ * and codes follow Linux's evdev so existing tables and habits apply.
+ */
+struct input_event {
+    uint64_t tsc;     // When it happened, in TSC cycles
+    uint16_t type;    // EV_*
+    uint16_t code;    // KEY_*, BTN_*, REL_*, SYN_*
+    int32_t value;    // 1 press / 0 release for keys, the delta for REL_*
+};
+
+#define INPUT_RING_SIZE 8192  // Bytes, 512 events
+
+// Types
+#define EV_SYN 0x00
+#define EV_KEY 0x01
+#define EV_REL 0x02
+
+// EV_SYN codes
+#define SYN_REPORT  0  // End of a group of events that happened together
+#define SYN_DROPPED 3  // The reader fell behind and events were lost before this
+
+// EV_KEY codes. Keys 1-88 are the same as scancode set 1 make codes.
+#define KEY_KPENTER   96
+#define KEY_RIGHTCTRL 97
+#define KEY_RIGHTALT  100
+#define KEY_HOME      102
+#define KEY_UP        103
+#define KEY_PAGEUP    104
+#define KEY_LEFT      105
+#define KEY_RIGHT     106
+#define KEY_END       107
+#define KEY_DOWN      108
+#define KEY_PAGEDOWN  109
+#define KEY_INSERT    110
+#define KEY_DELETE    111
+
+#define BTN_LEFT   0x110
+#define BTN_RIGHT  0x111
+#define BTN_MIDDLE 0x112
+
+// EV_REL codes
+#define REL_X     0x00
+#define REL_Y     0x01
+#define REL_WHEEL 0x08
+
+void input_init(void);
+
+// From drivers, any context. Events from one report should share a tsc.
+void input_event(uint64_t tsc, uint16_t type, uint16_t code, int32_t value);
+
+static inline void input_report_key(uint64_t tsc, uint16_t code, int32_t value) {
+    input_event(tsc, EV_KEY, code, value);
+}
+
+static inline void input_report_rel(uint64_t tsc, uint16_t code, int32_t value) {
+    if (value) {
+        input_event(tsc, EV_REL, code, value);
+    }
+}
+
+static inline void input_sync(uint64_t tsc) {
+    input_event(tsc, EV_SYN, SYN_REPORT, 0);
+}
+
+uint32_t input_dropped(void);
+
+#endif // INPUT_H
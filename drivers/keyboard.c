@@ -11,6 +11,9 @@
 #include "usb.h"
 #include "keyboard.h"
 #include "../kernel/print.h"
+#include "../kernel/delay.h"
+
+#define KEYBOARD_TIMEOUT_US 50000  // 50 ms per command
 
 void init_keyboard(void) {
     volatile unsigned int *usb_keyboard_ctrl = (volatile unsigned int *)USB_KEYBOARD_CTRL;
@@ -24,12 +27,9 @@ void init_keyboard(void) {
     print("Sent reset command to keyboard.\n");
 
     // Wait for the reset to complete
-    unsigned int timeout = 1000000;
-    while (!(*usb_keyboard_status & USB_KEYBOARD_STATUS_READY)) {
-        if (--timeout == 0) {
-            print("Timeout waiting for keyboard reset.\n");
-            return;
-        }
+    if (poll_until(*usb_keyboard_status & USB_KEYBOARD_STATUS_READY, KEYBOARD_TIMEOUT_US)) {
+        print("Timeout waiting for keyboard reset.\n");
+        return;
     }
     print("Keyboard reset complete.\n");
 
@@ -38,12 +38,9 @@ void init_keyboard(void) {
     print("Sent enable command to keyboard.\n");
 
     // Wait for the initialization to complete
-    timeout = 1000000;
-    while (!(*usb_keyboard_status & USB_KEYBOARD_STATUS_READY)) {
-        if (--timeout == 0) {
-            print("Timeout waiting for keyboard initialization.\n");
-            return;
-        }
+    if (poll_until(*usb_keyboard_status & USB_KEYBOARD_STATUS_READY, KEYBOARD_TIMEOUT_US)) {
+        print("Timeout waiting for keyboard initialization.\n");
+        return;
     }
 
     print("Keyboard initialization complete.\n");
@@ -4,78 +4,278 @@
  *
  * PS/2 mouse driver.
  *
- * Copyright (C) 2024 Goldside543
+ * Copyright (C) 2024-2026 Goldside543
  *
  */
 
 #include "mouse.h"
 #include <stdint.h>
-#include "../kernel/print.h"
+#include "input.h"
+#include "ps2.h"
+#include "../kernel/apic.h"
+#include "../kernel/boottime.h"
+#include "../kernel/delay.h"
+#include "../kernel/io.h"
+#include "../kernel/kfifo.h"
+#include "../kernel/tsc.h"
+#include "../kernel/wait.h"
 
-#define MOUSE_DATA_PORT 0x60
-#define MOUSE_COMMAND_PORT 0x64
-#define TIMEOUT 3000000
+#define MOUSE_TIMEOUT_US 100000  // 100 ms for the controller to take a byte
 
-// Function to read a byte from a hardware port
-static uint8_t inb(uint16_t port) {
-    uint8_t result;
-    __asm__("inb %1, %0" : "=a"(result) : "Nd"(port));
-    return result;
+// Controller commands
+#define PS2_CMD_READ_CONFIG  0x20
+#define PS2_CMD_WRITE_CONFIG 0x60
+#define PS2_CMD_ENABLE_AUX   0xA8
+#define PS2_CMD_WRITE_AUX    0xD4  // Next data byte goes to the mouse
+
+#define PS2_CONFIG_AUX_IRQ   0x02  // IRQ12 on mouse data
+#define PS2_CONFIG_AUX_CLOCK 0x20  // Set to disable the mouse clock
+
+// Mouse commands
+#define MOUSE_CMD_GET_ID        0xF2
+#define MOUSE_CMD_SAMPLE_RATE   0xF3
+#define MOUSE_CMD_ENABLE        0xF4
+#define MOUSE_CMD_DEFAULTS      0xF6
+#define MOUSE_ACK               0xFA
+
+#define MOUSE_ID_INTELLIMOUSE   3
+
+// First byte of a packet
+#define MOUSE_SYNC         0x08  // Always set
+#define MOUSE_X_SIGN       0x10
+#define MOUSE_Y_SIGN       0x20
+#define MOUSE_X_OVERFLOW   0x40
+#define MOUSE_Y_OVERFLOW   0x80
+
+// Producer is mouse_isr(), consumer is whoever reads events
+DEFINE_KFIFO(mouse_events, MOUSE_EVENT_RING_SIZE);
+
+static uint8_t mouse_packet[4];
+static uint32_t mouse_packet_len = 3;  // 4 with a wheel
+static uint32_t mouse_index;
+static uint64_t mouse_last_tsc;
+static uint64_t mouse_resync_cycles;   // 0 without a calibrated TSC
+static uint8_t mouse_last_buttons;     // For press/release events
+static struct mouse_stats mouse_stats;
+
+static int ps2_wait_write(void) {
+    return poll_until(!(inb(PS2_STATUS_PORT) & PS2_STATUS_INPUT_FULL), MOUSE_TIMEOUT_US);
 }
 
-// Function to write a byte to a hardware port
-static void outb(uint16_t port, uint8_t value) {
-    __asm__("outb %0, %1" : : "a"(value), "Nd"(port));
+static int ps2_wait_read(void) {
+    return poll_until(inb(PS2_STATUS_PORT) & PS2_STATUS_OUTPUT_FULL, MOUSE_TIMEOUT_US);
 }
 
-void mouse_init(void) {
-    print("Loading mouse driver...\n");
+static int ps2_command(uint8_t cmd) {
+    if (ps2_wait_write()) {
+        return -1;
+    }
+
+    outb(PS2_COMMAND_PORT, cmd);
+    return 0;
+}
+
+static int ps2_write_data(uint8_t data) {
+    if (ps2_wait_write()) {
+        return -1;
+    }
+
+    outb(PS2_DATA_PORT, data);
+    return 0;
+}
+
+static int ps2_read_data(uint8_t *data) {
+    if (ps2_wait_read()) {
+        return -1;
+    }
+
+    *data = inb(PS2_DATA_PORT);
+    return 0;
+}
+
+// Send a byte to the mouse and wait for its ACK
+static int mouse_write(uint8_t byte) {
+    uint8_t ack;
 
-    // Wait until the mouse is ready with timeout
-    int timeout = TIMEOUT;
-    while (inb(MOUSE_COMMAND_PORT) & 0x02) {
-        if (--timeout <= 0) {
-            print("Mouse not found. Boot continuing without driver.\n");
-            return;
-        }
+    if (ps2_command(PS2_CMD_WRITE_AUX) || ps2_write_data(byte) || ps2_read_data(&ack)) {
+        return -1;
     }
 
+    return ack == MOUSE_ACK ? 0 : -1;
+}
+
+static int mouse_set_sample_rate(uint8_t rate) {
+    if (mouse_write(MOUSE_CMD_SAMPLE_RATE)) {
+        return -1;
+    }
+
+    return mouse_write(rate);
+}
+
+// The magic 200, 100, 80 sample rate knock turns on the wheel
+static int mouse_enable_wheel(void) {
+    uint8_t id;
+
+    if (mouse_set_sample_rate(200) || mouse_set_sample_rate(100) || mouse_set_sample_rate(80)) {
+        return 0;
+    }
+
+    if (mouse_write(MOUSE_CMD_GET_ID) || ps2_read_data(&id)) {
+        return 0;
+    }
+
+    return id == MOUSE_ID_INTELLIMOUSE;
+}
+
+void mouse_init(void) {
+    uint8_t config;
+
+    boot_print("Loading mouse driver...\n");
+
     // Enable the auxiliary mouse device
-    outb(MOUSE_COMMAND_PORT, 0xA8);
+    if (ps2_command(PS2_CMD_ENABLE_AUX)) {
+        boot_print("Mouse not found. Boot continuing without driver.\n");
+        return;
+    }
+
+    // IRQ12 on, mouse clock running
+    if (ps2_command(PS2_CMD_READ_CONFIG) || ps2_read_data(&config)) {
+        boot_print("Couldn't read the PS/2 configuration byte.\n");
+        return;
+    }
+    config = (config | PS2_CONFIG_AUX_IRQ) & ~PS2_CONFIG_AUX_CLOCK;
+    if (ps2_command(PS2_CMD_WRITE_CONFIG) || ps2_write_data(config)) {
+        boot_print("Couldn't write the PS/2 configuration byte.\n");
+        return;
+    }
+
+    if (mouse_write(MOUSE_CMD_DEFAULTS)) {
+        boot_print("Mouse didn't answer. Boot continuing without driver.\n");
+        return;
+    }
+
+    if (mouse_enable_wheel()) {
+        mouse_packet_len = 4;
+        boot_print("IntelliMouse wheel enabled.\n");
+    }
 
-    // Read the current configuration byte
-    outb(MOUSE_COMMAND_PORT, 0x20);
-    uint8_t status = inb(MOUSE_DATA_PORT);
+    mouse_resync_cycles = (uint64_t)tsc_khz * MOUSE_RESYNC_MS;
 
-    // Set the configuration byte (enable interrupts)
-    outb(MOUSE_COMMAND_PORT, 0x60);
-    outb(MOUSE_DATA_PORT, status | 0x02);
+    if (mouse_write(MOUSE_CMD_ENABLE)) {
+        boot_print("Mouse wouldn't enable streaming.\n");
+        return;
+    }
 
-    // Enable the mouse
-    outb(MOUSE_COMMAND_PORT, 0xF4);
-    outb(MOUSE_DATA_PORT, 0xF4); // Send enable command
+    irq_unmask(12);
 
-    print("Mouse driver loaded.\n");
+    boot_print("Mouse driver loaded.\n");
 }
 
-void mouse_update(MouseState *state) {
-    // Wait until the mouse is ready
-    while (!(inb(MOUSE_COMMAND_PORT) & 0x01)) {
-        // Mouse data not ready, wait
+// Same packet again for /dev/input, one SYN_REPORT per packet
+static void mouse_report_input(const struct mouse_event *ev) {
+    uint8_t changed = ev->buttons ^ mouse_last_buttons;
+
+    if (changed & MOUSE_BUTTON_LEFT) {
+        input_report_key(ev->tsc, BTN_LEFT, !!(ev->buttons & MOUSE_BUTTON_LEFT));
+    }
+    if (changed & MOUSE_BUTTON_RIGHT) {
+        input_report_key(ev->tsc, BTN_RIGHT, !!(ev->buttons & MOUSE_BUTTON_RIGHT));
+    }
+    if (changed & MOUSE_BUTTON_MIDDLE) {
+        input_report_key(ev->tsc, BTN_MIDDLE, !!(ev->buttons & MOUSE_BUTTON_MIDDLE));
     }
+    mouse_last_buttons = ev->buttons;
 
-    // Read mouse data
-    uint8_t mouse_data[3];
-    for (int i = 0; i < 3; i++) {
-        mouse_data[i] = inb(MOUSE_DATA_PORT);
+    input_report_rel(ev->tsc, REL_X, ev->dx);
+    input_report_rel(ev->tsc, REL_Y, ev->dy);
+    input_report_rel(ev->tsc, REL_WHEEL, -ev->dz);  // The mouse counts down as positive
+    input_sync(ev->tsc);
+}
+
+static void mouse_receive(uint8_t byte) {
+    struct mouse_event ev;
+    uint64_t now = rdtsc();
+    uint8_t flags;
+
+    // The rest of a packet follows right away, a pause means a byte went missing
+    if (mouse_index && mouse_resync_cycles && now - mouse_last_tsc > mouse_resync_cycles) {
+        mouse_index = 0;
+        mouse_stats.resyncs++;
+    }
+    mouse_last_tsc = now;
+
+    if (mouse_index == 0 && !(byte & MOUSE_SYNC)) {
+        mouse_stats.resyncs++;
+        return;
     }
 
-    // Parse mouse data
-    state->buttons = mouse_data[0] & 0x07;
-    state->x_delta = mouse_data[1];
-    state->y_delta = -mouse_data[2]; // Y axis is inverted
+    mouse_packet[mouse_index++] = byte;
+    if (mouse_index < mouse_packet_len) {
+        return;
+    }
+    mouse_index = 0;
+
+    flags = mouse_packet[0];
+    if (flags & (MOUSE_X_OVERFLOW | MOUSE_Y_OVERFLOW)) {
+        mouse_stats.overflows++;
+        return;
+    }
+
+    // Deltas are 9-bit two's complement, the sign bits live in the first byte
+    ev.tsc = now;
+    ev.dx = (int16_t)mouse_packet[1] - ((flags & MOUSE_X_SIGN) ? 0x100 : 0);
+    ev.dy = -((int16_t)mouse_packet[2] - ((flags & MOUSE_Y_SIGN) ? 0x100 : 0));
+    ev.dz = mouse_packet_len == 4 ? (int8_t)mouse_packet[3] : 0;
+    ev.buttons = flags & (MOUSE_BUTTON_LEFT | MOUSE_BUTTON_RIGHT | MOUSE_BUTTON_MIDDLE);
+    ev.pad = 0;
+
+    mouse_stats.packets++;
+    if (!kfifo_in(&mouse_events, &ev, sizeof(ev))) {
+        mouse_stats.dropped++;
+    }
+    mouse_report_input(&ev);
+}
+
+void mouse_isr(void) {
+    // Keyboard bytes are left for IRQ1
+    while ((inb(PS2_STATUS_PORT) & (PS2_STATUS_OUTPUT_FULL | PS2_STATUS_AUX_DATA)) ==
+           (PS2_STATUS_OUTPUT_FULL | PS2_STATUS_AUX_DATA)) {
+        mouse_receive(inb(PS2_DATA_PORT));
+    }
+}
+
+int mouse_read_event(struct mouse_event *ev) {
+    wait_event(kfifo_len(&mouse_events) >= sizeof(*ev));
+
+    return kfifo_out(&mouse_events, ev, sizeof(*ev));
+}
+
+int mouse_poll_event(struct mouse_event *ev) {
+    return kfifo_out(&mouse_events, ev, sizeof(*ev));
+}
+
+void mouse_update(MouseState *state) {
+    struct mouse_event ev;
+
+    state->x_delta = 0;
+    state->y_delta = 0;
+
+    while (mouse_poll_event(&ev)) {
+        state->x_delta += ev.dx;
+        state->y_delta += ev.dy;
+        state->z += ev.dz;
+        state->buttons = ev.buttons;
+    }
 
     // Update position
     state->x += state->x_delta;
     state->y += state->y_delta;
 }
+
+int mouse_has_wheel(void) {
+    return mouse_packet_len == 4;
+}
+
+void mouse_get_stats(struct mouse_stats *stats) {
+    *stats = mouse_stats;
+}
@@ -10,15 +10,44 @@
 #define MOUSE_BUTTON_RIGHT 0x02
 #define MOUSE_BUTTON_MIDDLE 0x04
 
+#define MOUSE_EVENT_RING_SIZE 4096  // Bytes, 256 events
+#define MOUSE_RESYNC_MS       20    // A gap this long inside a packet means we lost sync
+
+// One packet, as it came off IRQ12
+struct mouse_event {
+    uint64_t tsc;        // When the last byte arrived
+    int16_t dx;          // Right is positive
+    int16_t dy;          // Down is positive, like the screen
+    int8_t dz;           // Wheel, 0 without an IntelliMouse
+    uint8_t buttons;     // MOUSE_BUTTON_*
+    uint16_t pad;
+};
+
+struct mouse_stats {
+    uint32_t packets;
+    uint32_t resyncs;    // Bytes thrown away to find the start of a packet
+    uint32_t overflows;  // Packets with the overflow bits set, discarded
+    uint32_t dropped;    // Nobody was reading and the ring filled up
+};
+
 // Define a structure for mouse state
 typedef struct {
     int x, y;                      // Current position of the mouse
+    int z;                         // Wheel position
     uint8_t buttons;               // Current button states
-    int8_t x_delta, y_delta;       // Movement deltas
+    int16_t x_delta, y_delta;      // Movement deltas
 } MouseState;
 
 // Function prototypes
 void mouse_init(void);              // Initialize the mouse driver
-void mouse_update(MouseState *state); // Update the mouse state
+void mouse_isr(void);               // IRQ12, called from mouse_isr_wrapper
+
+// A single reader takes events off the ring
+int mouse_read_event(struct mouse_event *ev);  // Blocks until there is one
+int mouse_poll_event(struct mouse_event *ev);  // 1 if there was one, never waits
+void mouse_update(MouseState *state); // Apply whatever is queued, never waits
+
+int mouse_has_wheel(void);
+void mouse_get_stats(struct mouse_stats *stats);
 
 #endif // MOUSE_H
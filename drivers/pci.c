@@ -9,10 +9,12 @@
  */
 
 #include "../kernel/print.h"
+#include "../kernel/kprintf.h"
 #include "../kernel/io.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "pci.h"
 
 #define PCI_CONFIG_ADDRESS 0xCF8
 #define PCI_CONFIG_DATA    0xCFC
@@ -109,39 +111,8 @@ void pci_scan_bus() {
                 uint8_t class_code = (class_subclass >> 24) & 0xFF;
                 uint8_t subclass_code = (class_subclass >> 16) & 0xFF;
 
-                // Allocate string buffers to hold the values as strings
-                char buffer[32];  // Sufficient for 32-bit integer
-
-                // Print the values using the itoa function
-                print("\nBus: ");
-                itoa(bus, buffer, 10); // Convert bus to string
-                print(buffer);
-
-                print(" Device: ");
-                itoa(device, buffer, 10); // Convert device to string
-                print(buffer);
-
-                print(" Vendor ID: ");
-                print("0x");
-                itoa(vendor_id, buffer, 16); // Convert vendor_id to hex string
-                print(buffer);
-
-                print(" Device ID: ");
-                print("0x");
-                itoa(device_id, buffer, 16); // Convert device_id to hex string
-                print(buffer);
-
-                print(" Class: ");
-                print("0x");
-                itoa(class_code, buffer, 16); // Convert class_code to hex string
-                print(buffer);
-
-                print(" Subclass: ");
-                print("0x");
-                itoa(subclass_code, buffer, 16); // Convert subclass_code to hex string
-                print(buffer);
-
-                print("\n");
+                kprintf("\nBus: %u Device: %u Vendor ID: 0x%x Device ID: 0x%x Class: 0x%x Subclass: 0x%x\n",
+                        bus, device, vendor_id, device_id, class_code, subclass_code);
             }
 
             // If no valid functions were found for this device, skip to the next device
@@ -182,11 +153,7 @@ uint32_t* find_rtl8139_dma_address() {
                     // Check if BAR0 is valid (non-zero)
                     if (bar0 != 0) {
                         // Assuming BAR0 contains the DMA address (memory-mapped)
-                        print("Found RTL8139! DMA Base Address: ");
-                        char buffer[32];
-                        itoa(bar0, buffer, 16);  // Convert the DMA address to hex string
-                        print(buffer);
-                        print("\n");
+                        kprintf("Found RTL8139! DMA Base Address: %x\n", bar0);
 
                         return (uint32_t*)bar0;  // Return the DMA base address
                     }
@@ -3,6 +3,11 @@
 #ifndef PCI_H
 #define PCI_H
 
+#include <stdint.h>
+
+// Unsigned number to a string, str needs room for 33 chars in base 2
+void itoa(uint32_t num, char* str, int base);
+
 void pci_scan_bus();
 uint32_t* find_rtl8139_dma_address();
 
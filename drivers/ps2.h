@@ -0,0 +1,15 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PS2_H
+#define PS2_H
+
+// 8042 controller, shared by the keyboard and the mouse
+#define PS2_DATA_PORT    0x60
+#define PS2_STATUS_PORT  0x64
+#define PS2_COMMAND_PORT 0x64
+
+#define PS2_STATUS_OUTPUT_FULL 0x01  // A byte is waiting in the data port
+#define PS2_STATUS_INPUT_FULL  0x02  // Controller hasn't taken the last byte yet
+#define PS2_STATUS_AUX_DATA    0x20  // The waiting byte is from the mouse
+
+#endif // PS2_H
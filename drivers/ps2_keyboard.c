@@ -0,0 +1,201 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * drivers/ps2_keyboard.c
+ *
+ * PS/2 keyboard driver.
+ *
+ * Copyright (C) 2024-2026 Goldside543
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "console.h"
+#include "input.h"
+#include "ps2.h"
+#include "ps2_keyboard.h"
+#include "../kernel/apic.h"
+#include "../kernel/io.h"
+#include "../kernel/irqflags.h"
+#include "../kernel/kfifo.h"
+#include "../kernel/softirq.h"
+#include "../kernel/tsc.h"
+#include "../kernel/tty.h"
+
+// Improved scancode to ASCII table
+static const char scancode_to_ascii_table[128] = {
+    0, 0, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b', '\t',  // '\b' is backspace, '\t' is tab
+    'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n', 0,  // '\n' is enter
+    'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`', 0,
+    '\\', 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0, '*',
+    0, ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '7',
+    '8', '9', '-', '4', '5', '6', '+', '1', '2', '3', '0', '.', 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// E0-prefixed scancodes to input keycodes, the rest map 1:1
+static const uint8_t extended_keycode_table[128] = {
+    [0x1C] = KEY_KPENTER, [0x1D] = KEY_RIGHTCTRL, [0x38] = KEY_RIGHTALT,
+    [0x47] = KEY_HOME, [0x48] = KEY_UP, [0x49] = KEY_PAGEUP,
+    [0x4B] = KEY_LEFT, [0x4D] = KEY_RIGHT, [0x4F] = KEY_END,
+    [0x50] = KEY_DOWN, [0x51] = KEY_PAGEDOWN, [0x52] = KEY_INSERT,
+    [0x53] = KEY_DELETE,
+};
+
+// Producer is keyboard_isr(), consumer is the input softirq
+DEFINE_KFIFO(scancode_ring, SCANCODE_RING_SIZE);
+
+// Translated characters waiting for the tty to take another line
+DEFINE_KFIFO(tty_pending, SCANCODE_RING_SIZE);
+static uint32_t tty_dropped;  // Typed while tty_pending was full
+
+static bool shift_pressed = false;
+static bool extended = false;
+
+/*
+ * Move bytes from the controller into the ring. When the ring is full
+ * they're left in the controller, which holds them (and the keyboard
+ * stops sending) until the softirq has caught up. Scancodes aren't
+ * lost, but characters the tty won't take can be, see below.
+ */
+static void ps2_keyboard_pull(void) {
+    uint8_t status;
+
+    while (!kfifo_is_full(&scancode_ring)) {
+        status = inb(PS2_STATUS_PORT);
+
+        // Mouse bytes are left for IRQ12
+        if ((status & (PS2_STATUS_OUTPUT_FULL | PS2_STATUS_AUX_DATA)) != PS2_STATUS_OUTPUT_FULL) {
+            break;
+        }
+
+        kfifo_put(&scancode_ring, inb(PS2_DATA_PORT));
+    }
+}
+
+// Top half, just get the bytes off the controller
+void keyboard_isr(void) {
+    ps2_keyboard_pull();
+    raise_softirq_irqoff(INPUT_SOFTIRQ);
+}
+
+// Returns the character for a scancode, or 0 if it doesn't make one
+static char ps2_keyboard_translate(uint8_t scancode) {
+    char ascii;
+
+    if (scancode == 0xE0) {  // If it's the first byte of a multi-byte scan code
+        extended = true;
+        return 0;
+    }
+
+    if (scancode & 0x80) {  // If it's a key release event
+        if (scancode == 0xAA || scancode == 0xB6) {  // Left or right Shift release
+            shift_pressed = false;
+        }
+        extended = false;  // Reset the extended flag
+        return 0;
+    }
+
+    if (scancode == 0x2A || scancode == 0x36) {  // Left or right Shift press
+        shift_pressed = true;
+        return 0;
+    }
+
+    if (extended) {  // Arrow keys and friends, only Shift+PgUp/PgDn do anything
+        extended = false;
+        if (shift_pressed && scancode == 0x49) {
+            console_scroll(-CONSOLE_ROWS / 2);
+        } else if (shift_pressed && scancode == 0x51) {
+            console_scroll(CONSOLE_ROWS / 2);
+        }
+        return 0;
+    }
+
+    // Convert scan code to ASCII
+    ascii = scancode_to_ascii_table[scancode];
+
+    if (shift_pressed && ascii >= 'a' && ascii <= 'z') {
+        ascii -= ('a' - 'A');  // Convert to uppercase
+    }
+
+    return ascii;
+}
+
+// Press or release for /dev/input, before translation eats the prefix
+static void ps2_keyboard_report(uint8_t scancode, bool is_extended) {
+    uint8_t key = scancode & 0x7F;
+    uint64_t now;
+
+    if (scancode == 0xE0) {
+        return;
+    }
+
+    if (is_extended) {
+        key = extended_keycode_table[key];
+        if (!key) {
+            return;  // Fake shifts and the like
+        }
+    }
+
+    now = rdtsc();
+    input_report_key(now, key, !(scancode & 0x80));
+    input_sync(now);
+}
+
+static void ps2_keyboard_unthrottle(void) {
+    raise_softirq(INPUT_SOFTIRQ);
+}
+
+/*
+ * Bottom half, translation and line editing with interrupts on. The
+ * scancode ring is always drained so input events keep flowing and the
+ * controller never sits on a byte (which would hold up IRQ12 too), only
+ * the characters for the tty wait until a reader makes room. If that
+ * backlog fills up too, further characters are dropped and counted.
+ */
+static void ps2_keyboard_softirq(void) {
+    uint8_t scancode;
+    uint8_t c;
+    uint32_t flags;
+
+    for (;;) {
+        if (!kfifo_get(&scancode_ring, &scancode)) {
+            // Pick up anything the controller held on to while we were full
+            local_irq_save(flags);
+            ps2_keyboard_pull();
+            local_irq_restore(flags);
+
+            if (kfifo_is_empty(&scancode_ring)) {
+                break;
+            }
+            continue;
+        }
+
+        ps2_keyboard_report(scancode, extended);
+
+        c = ps2_keyboard_translate(scancode);
+        if (c && !kfifo_put(&tty_pending, c)) {
+            tty_dropped++;  // Nobody's reading, input events still got it
+        }
+    }
+
+    while (kfifo_peek(&tty_pending, &c)) {
+        if (!tty_can_receive()) {
+            tty_throttle(ps2_keyboard_unthrottle);
+            return;
+        }
+
+        kfifo_skip(&tty_pending);
+        tty_receive_char(c);
+    }
+}
+
+uint32_t ps2_keyboard_dropped(void) {
+    return tty_dropped;
+}
+
+void ps2_keyboard_init(void) {
+    open_softirq(INPUT_SOFTIRQ, ps2_keyboard_softirq);
+    irq_unmask(1);
+}
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PS2_KEYBOARD_H
+#define PS2_KEYBOARD_H
+
+#include <stdint.h>
+
+#define SCANCODE_RING_SIZE 256  // Power of two
+
+void ps2_keyboard_init(void);
+
+// IRQ1 top half, called from keyboard_isr_wrapper
+void keyboard_isr(void);
+
+// Characters thrown away because the tty wasn't reading
+uint32_t ps2_keyboard_dropped(void);
+
+#endif // PS2_KEYBOARD_H
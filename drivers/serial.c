@@ -4,52 +4,305 @@
  * 
  * Serial driver.
  *
- * Copyright (C) 2025 Goldside543
+ * Copyright (C) 2025-2026 Goldside543
  *
  */
 
+#include <stddef.h>
+#include <stdint.h>
+#include "serial.h"
+#include "../kernel/apic.h"
+#include "../kernel/delay.h"
 #include "../kernel/io.h"
+#include "../kernel/irqflags.h"
+#include "../kernel/kfifo.h"
+#include "../kernel/softirq.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/wait.h"
 
 #define PORT 0x3f8          // COM1
 
+// Register offsets from PORT
+#define UART_DATA 0
+#define UART_IER  1
+#define UART_IIR  2  // Read
+#define UART_FCR  2  // Write
+#define UART_LCR  3
+#define UART_MCR  4
+#define UART_LSR  5
+#define UART_MSR  6
+
+#define IER_RDI   0x01  // Received data available
+#define IER_THRI  0x02  // Transmit holding register empty
+#define IER_RLSI  0x04  // Line status
+
+#define IIR_NO_INT     0x01
+#define IIR_ID_MASK    0x0E
+#define IIR_THRI       0x02
+#define IIR_RDI        0x04
+#define IIR_RLSI       0x06
+#define IIR_RX_TIMEOUT 0x0C
+#define IIR_FIFO_MASK  0xC0  // Both set on a 16550A with working FIFOs
+
+#define LCR_8N1   0x03
+#define LCR_DLAB  0x80
+
+#define MCR_DTR   0x01
+#define MCR_RTS   0x02
+#define MCR_OUT1  0x04
+#define MCR_OUT2  0x08  // Gates the IRQ line on PCs
+#define MCR_LOOP  0x10
+
+#define LSR_DR    0x01
+#define LSR_OE    0x02
+#define LSR_THRE  0x20
+#define LSR_TEMT  0x40
+
+#define UART_CLOCK     115200  // Divisor 1
+#define UART_FIFO_SIZE 16
+
+DEFINE_KFIFO(serial_tx, SERIAL_TX_RING_SIZE);
+DEFINE_KFIFO(serial_rx, SERIAL_RX_RING_SIZE);
+
+// Writers and the interrupt handler share the tx ring and the UART
+static DEFINE_SPINLOCK(serial_lock);
+
+static int serial_present;
+static uint32_t serial_tx_burst = 1;  // Bytes we can write per THRE
+static uint32_t serial_baud;
+static uint8_t serial_ier;
+static struct serial_stats serial_stats;
+
+// Long enough for a full FIFO plus the shift register to go out, 10 bits a byte
+static uint32_t serial_drain_us(void) {
+    return (UART_FIFO_SIZE + 1) * 10 * (1000000 / serial_baud + 1);
+}
+
+static void serial_set_ier(uint8_t ier) {
+    if (ier != serial_ier) {
+        serial_ier = ier;
+        outb(PORT + UART_IER, ier);
+    }
+}
+
+// With serial_lock held. THRE means the whole FIFO is empty, so fill it.
+static void serial_fill_fifo(void) {
+    uint8_t c;
+
+    if (!(inb(PORT + UART_LSR) & LSR_THRE)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < serial_tx_burst && kfifo_get(&serial_tx, &c); i++) {
+        outb(PORT + UART_DATA, c);
+        serial_stats.tx_bytes++;
+    }
+}
+
+// With serial_lock held. Sends what fits now, THRE interrupts do the rest.
+static void serial_start_tx(void) {
+    serial_fill_fifo();
+
+    if (kfifo_is_empty(&serial_tx)) {
+        serial_set_ier(serial_ier & ~IER_THRI);
+    } else {
+        serial_set_ier(serial_ier | IER_THRI);
+    }
+}
+
 int init_serial() {
-   outb(PORT + 1, 0x00);    // Disable all interrupts
-   outb(PORT + 3, 0x80);    // Enable DLAB (set baud rate divisor)
-   outb(PORT + 0, 0x03);    // Set divisor to 3 (lo byte) 38400 baud
-   outb(PORT + 1, 0x00);    //                  (hi byte)
-   outb(PORT + 3, 0x03);    // 8 bits, no parity, one stop bit
-   outb(PORT + 2, 0xC7);    // Enable FIFO, clear them, with 14-byte threshold
-   outb(PORT + 4, 0x0B);    // IRQs enabled, RTS/DSR set
-   outb(PORT + 4, 0x1E);    // Set in loopback mode, test the serial chip
-   outb(PORT + 0, 0xAE);    // Test serial chip (send byte 0xAE and check if serial returns same byte)
+    uint32_t divisor = UART_CLOCK / SERIAL_DEFAULT_BAUD;
+    uint32_t flags;
+
+    outb(PORT + UART_IER, 0x00);    // Disable all interrupts
+    outb(PORT + UART_LCR, LCR_DLAB);  // Enable DLAB (set baud rate divisor)
+    outb(PORT + UART_DATA, divisor & 0xFF);
+    outb(PORT + UART_IER, divisor >> 8);
+    outb(PORT + UART_LCR, LCR_8N1);   // 8 bits, no parity, one stop bit
+    outb(PORT + UART_FCR, 0xC7);    // Enable FIFO, clear them, with 14-byte threshold
+    outb(PORT + UART_MCR, MCR_RTS | MCR_OUT1 | MCR_OUT2 | MCR_LOOP);  // Loopback, test the serial chip
+    outb(PORT + UART_DATA, 0xAE);
+
+    // Check if serial is faulty (i.e: not same byte as sent)
+    if (inb(PORT + UART_DATA) != 0xAE) {
+        return 1;
+    }
+
+    // Older parts have a one byte holding register and nothing else
+    serial_tx_burst = (inb(PORT + UART_IIR) & IIR_FIFO_MASK) == IIR_FIFO_MASK ? UART_FIFO_SIZE : 1;
+    serial_baud = SERIAL_DEFAULT_BAUD;
 
-   // Check if serial is faulty (i.e: not same byte as sent)
-   if(inb(PORT + 0) != 0xAE) {
-      return 1;
-   }
+    // Normal operation, IRQs through OUT2
+    outb(PORT + UART_MCR, MCR_DTR | MCR_RTS | MCR_OUT2);
 
-   // If serial is not faulty set it in normal operation mode
-   // (not-loopback with IRQs enabled and OUT#1 and OUT#2 bits enabled)
-   outb(PORT + 4, 0x0F);
-   return 0;
+    spin_lock_irqsave(&serial_lock, flags);
+    serial_present = 1;
+    serial_set_ier(IER_RDI | IER_RLSI);
+    serial_start_tx();  // Anything written before we got here
+    spin_unlock_irqrestore(&serial_lock, flags);
+
+    irq_unmask(4);
+    return 0;
 }
 
-int serial_received() {
-   return inb(PORT + 5) & 1;
+// Only divisors of the 115200 base clock are exact, so only those are taken
+int serial_set_baud(uint32_t baud) {
+    uint32_t divisor, flags;
+
+    if (!serial_present || baud == 0 || baud > UART_CLOCK || UART_CLOCK % baud) {
+        return -1;
+    }
+    divisor = UART_CLOCK / baud;
+
+    spin_lock_irqsave(&serial_lock, flags);
+
+    // Let the byte on the wire finish at the old rate
+    if (poll_until(inb(PORT + UART_LSR) & LSR_TEMT, serial_drain_us())) {
+        spin_unlock_irqrestore(&serial_lock, flags);
+        return -1;  // Transmitter is stuck, leave the rate alone
+    }
+
+    outb(PORT + UART_LCR, LCR_DLAB | LCR_8N1);
+    outb(PORT + UART_DATA, divisor & 0xFF);
+    outb(PORT + UART_IER, divisor >> 8);
+    outb(PORT + UART_LCR, LCR_8N1);
+    outb(PORT + UART_IER, serial_ier);  // DLAB hid it, put it back
+    serial_baud = baud;
+
+    serial_start_tx();
+    spin_unlock_irqrestore(&serial_lock, flags);
+
+    return 0;
 }
 
-char read_serial() {
-   while (serial_received() == 0);
+uint32_t serial_get_baud(void) {
+    return serial_baud;
+}
 
-   return inb(PORT);
+uint32_t serial_fifo_size(void) {
+    return serial_tx_burst;
 }
 
-int is_transmit_empty() {
-   return inb(PORT + 5) & 0x20;
+/*
+ * Queue as much as fits and go. Only a full ring holds the caller up:
+ * with interrupts on it sleeps until THRE makes room, otherwise it
+ * has to push the FIFO out itself. Without a UART, or with one that
+ * stops draining, the excess is lost.
+ */
+size_t serial_write(const char *buf, size_t len) {
+    size_t done = 0;
+    uint32_t flags;
+    int stuck = 0;
+
+    while (done < len) {
+        spin_lock_irqsave(&serial_lock, flags);
+
+        while (done < len && kfifo_put(&serial_tx, buf[done])) {
+            done++;
+        }
+
+        if (serial_present) {
+            serial_start_tx();
+
+            if (done < len) {
+                serial_stats.tx_waits++;
+            }
+
+            if (done < len && (!(flags & EFLAGS_IF) || in_interrupt())) {
+                if (poll_until(inb(PORT + UART_LSR) & LSR_THRE, serial_drain_us())) {
+                    stuck = 1;
+                } else {
+                    serial_fill_fifo();
+                }
+            }
+        }
+
+        spin_unlock_irqrestore(&serial_lock, flags);
+
+        if (done < len) {
+            if (!serial_present || stuck) {
+                break;
+            }
+
+            if ((flags & EFLAGS_IF) && !in_interrupt()) {
+                wait_event(kfifo_avail(&serial_tx) >= UART_FIFO_SIZE);
+            }
+        }
+    }
+
+    return done;
 }
 
 void write_serial(char a) {
-   while (is_transmit_empty() == 0);
+    serial_write(&a, 1);
+}
+
+void write_serial_string(const char *str) {
+    const char *start = str;
+
+    for (; *str; str++) {
+        if (*str == '\n') {
+            serial_write(start, str - start);
+            serial_write("\r\n", 2);
+            start = str + 1;
+        }
+    }
+
+    serial_write(start, str - start);
+}
+
+char read_serial() {
+    uint8_t c;
+
+    wait_event(!kfifo_is_empty(&serial_rx));
+    kfifo_get(&serial_rx, &c);
+
+    return c;
+}
+
+// With serial_lock held
+static void serial_receive(void) {
+    uint8_t lsr;
+
+    while ((lsr = inb(PORT + UART_LSR)) & LSR_DR) {
+        if (lsr & LSR_OE) {
+            serial_stats.rx_overruns++;
+        }
+
+        if (kfifo_put(&serial_rx, inb(PORT + UART_DATA))) {
+            serial_stats.rx_bytes++;
+        } else {
+            serial_stats.rx_dropped++;
+        }
+    }
+}
+
+// IRQ4, keep going until the UART has nothing left to say
+void serial_isr(void) {
+    uint8_t iir;
+
+    spin_lock(&serial_lock);
+    serial_stats.irqs++;
+
+    while (!((iir = inb(PORT + UART_IIR)) & IIR_NO_INT)) {
+        switch (iir & IIR_ID_MASK) {
+            case IIR_RDI:
+            case IIR_RX_TIMEOUT:
+            case IIR_RLSI:
+                serial_receive();
+                break;
+            case IIR_THRI:
+                serial_start_tx();
+                break;
+            default:
+                inb(PORT + UART_MSR);  // Modem status, not used
+                break;
+        }
+    }
+
+    spin_unlock(&serial_lock);
+}
 
-   outb(PORT,a);
+void serial_get_stats(struct serial_stats *stats) {
+    *stats = serial_stats;
 }
@@ -3,8 +3,35 @@
 #ifndef SERIAL_H
 #define SERIAL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+#define SERIAL_TX_RING_SIZE 16384
+#define SERIAL_RX_RING_SIZE 1024
+#define SERIAL_DEFAULT_BAUD 115200
+
+struct serial_stats {
+    uint32_t tx_bytes;     // Bytes handed to the UART
+    uint32_t rx_bytes;     // Bytes taken from it
+    uint32_t tx_waits;     // Writers that found the ring full and had to wait
+    uint32_t rx_dropped;   // Received with the ring full
+    uint32_t rx_overruns;  // Lost in the UART before we got to them
+    uint32_t irqs;
+};
+
 int init_serial();
-char read_serial();
+int serial_set_baud(uint32_t baud);
+uint32_t serial_get_baud(void);
+
+// Writes only queue, the UART drains the ring from its interrupt
+size_t serial_write(const char *buf, size_t len);
 void write_serial(char a);
+void write_serial_string(const char *str);
+
+char read_serial();
+
+void serial_isr(void);
+void serial_get_stats(struct serial_stats *stats);
+uint32_t serial_fifo_size(void);
 
 #endif // SERIAL_H
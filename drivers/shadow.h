@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SHADOW_H
+#define SHADOW_H
+
+#include <stdint.h>
+
+/*
+ * Helpers for drivers that draw into a RAM copy of the screen and only
+ * push the changed part out to VRAM now and then. VRAM is uncached, so
+ * it's only ever written, in whole dwords, and never read back.
+ */
+
+// Half-open rectangle in the driver's own units (cells or pixels)
+struct dirty_rect {
+    int x0, y0, x1, y1;
+};
+
+static inline void dirty_reset(struct dirty_rect *r) {
+    r->x0 = r->y0 = 0x7FFFFFFF;
+    r->x1 = r->y1 = 0;
+}
+
+static inline int dirty_empty(const struct dirty_rect *r) {
+    return r->x0 >= r->x1 || r->y0 >= r->y1;
+}
+
+static inline void dirty_add(struct dirty_rect *r, int x0, int y0, int x1, int y1) {
+    if (x0 < r->x0) r->x0 = x0;
+    if (y0 < r->y0) r->y0 = y0;
+    if (x1 > r->x1) r->x1 = x1;
+    if (y1 > r->y1) r->y1 = y1;
+}
+
+// dst and src dword aligned, len a multiple of 4
+static inline void vram_copy(volatile void *dst, const void *src, uint32_t len) {
+    uint32_t count = len / 4;
+
+    asm volatile("rep movsl"
+                 : "+D"(dst), "+S"(src), "+c"(count)
+                 :
+                 : "memory");
+}
+
+#endif // SHADOW_H
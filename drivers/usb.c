@@ -12,6 +12,9 @@
 #include "usb.h"
 #include "keyboard.h"  // Ensure this header file contains the declaration for keyboard_read
 #include "../kernel/print.h"
+#include "../kernel/delay.h"
+
+#define USB_READY_TIMEOUT_US 100000  // 100 ms
 
 // Define this variable to control which method to use
 static bool use_keyboard_driver = false;
@@ -25,13 +28,10 @@ void usb_init(void) {
     print("Checking for USB controller...\n");
 
     // Wait for the USB controller to be ready
-    unsigned int timeout = 3000000;  // Adjust timeout value if needed
-    while (!(*usb_status & USB_STATUS_READY)) {
-        if (--timeout == 0) {
-            use_keyboard_driver = false;  // Timeout occurred, set to use direct I/O
-            print("USB controller not found. Continuing boot without driver.\n");
-            return;
-        }
+    if (poll_until(*usb_status & USB_STATUS_READY, USB_READY_TIMEOUT_US)) {
+        use_keyboard_driver = false;  // Timeout occurred, set to use direct I/O
+        print("USB controller not found. Continuing boot without driver.\n");
+        return;
     }
 
     // USB controller is ready
@@ -10,6 +10,8 @@
 // vga_mode13.c
 #include <stdint.h>
 #include "../kernel/io.h"
+#include "console.h"
+#include "graphics.h"
 
 // VGA ports
 #define VGA_CRTC_INDEX 0x3D4
@@ -31,32 +33,6 @@
 #define MODE_13H_HEIGHT 200
 #define MODE_13H_DEPTH  256
 
-static void clear_text_mode_memory(void) {
-    uint16_t* text_mode = (uint16_t*)0xB8000;
-    for (int i = 0; i < 80 * 25; i++) {
-        text_mode[i] = 0x0700; // space, white on black
-    }
-}
-
-static void clear_graphics_memory(void) {
-    uint8_t* graphics_mode = (uint8_t*)VGA_MEMORY;
-    for (int i = 0; i < MODE_13H_WIDTH * MODE_13H_HEIGHT; i++) {
-        graphics_mode[i] = 0; // black
-    }
-}
-
-void clear_vmemory() {
-    clear_text_mode_memory();
-    clear_graphics_memory();
-}
-
-void clear_screen() {
-    uint8_t* screen = (uint8_t*)VGA_MEMORY;
-    for (int i = 0; i < (MODE_13H_WIDTH * MODE_13H_HEIGHT); i++) {
-        screen[i] = 1; // fill with palette color 1
-    }
-}
-
 /*
  * Set VGA mode 13h (320x200x256).
  *
@@ -72,7 +48,8 @@ void clear_screen() {
  * a monochrome adapter you'd need to use 0x3B4/0x3B5 for CRTC.
  */
 void set_mode_13h() {
-    clear_vmemory();
+    // The console's flush timer mustn't touch the CRTC under us
+    console_suspend();
 
     // 1) Misc output: select clock and enable graphics
     outb(VGA_MISC_WRITE, 0x63);
@@ -160,6 +137,7 @@ void set_mode_13h() {
     (void)inb(VGA_IS1_READ);
     outb(VGA_AC_INDEX, 0x20);
 
-    // 7) Clear the screen to a known color
-    clear_screen();
+    // 7) Clear the screen to a known color, through the shadow like everything else
+    fill_screen(1);
+    graphics_enable();
 }
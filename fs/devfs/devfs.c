@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * fs/devfs/devfs.c
+ *
+ * Device files under /dev.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include "devfs.h"
+#include "../vfs/vfs.h"
+#include "../../kernel/spinlock.h"
+#include "../../kernel/string.h"
+
+static struct device *devices[DEVFS_MAX_DEVICES];
+static DEFINE_SPINLOCK(devfs_lock);
+
+static FileSystem devfs;
+
+static struct device *devfs_lookup(const char *path) {
+    for (int i = 0; i < DEVFS_MAX_DEVICES; i++) {
+        if (devices[i] && my_strcmp(devices[i]->path, path) == 0) {
+            return devices[i];
+        }
+    }
+
+    return NULL;
+}
+
+static struct device *devfs_device(int fd) {
+    FileDescriptor *file = vfs_get_fd(fd);
+
+    return file ? file->private_data : NULL;
+}
+
+static int devfs_mount(const char *device) {
+    return 0;
+}
+
+static int devfs_unmount() {
+    return 0;
+}
+
+static int devfs_open(const char *path, int flags) {
+    struct device *dev = devfs_lookup(path);
+    int fd;
+
+    if (!dev || (dev->open && dev->open(flags) != 0)) {
+        return -1;
+    }
+
+    fd = vfs_alloc_fd(&devfs, dev, flags);
+    if (fd < 0 && dev->release) {
+        dev->release();
+    }
+
+    return fd;
+}
+
+static int devfs_close(int fd) {
+    struct device *dev = devfs_device(fd);
+
+    if (dev && dev->release) {
+        dev->release();
+    }
+
+    return 0;
+}
+
+static int devfs_read(int fd, void *buf, size_t size) {
+    struct device *dev = devfs_device(fd);
+
+    if (!dev || !dev->read) {
+        return -1;
+    }
+
+    return dev->read(buf, size, vfs_get_fd(fd)->flags);
+}
+
+static int devfs_write(int fd, const void *buf, size_t size) {
+    struct device *dev = devfs_device(fd);
+
+    if (!dev || !dev->write) {
+        return -1;
+    }
+
+    return dev->write(buf, size, vfs_get_fd(fd)->flags);
+}
+
+static int devfs_stat(const char *path, struct stat *st) {
+    if (!devfs_lookup(path)) {
+        return -1;
+    }
+
+    st->st_size = 0;
+    st->st_mode = S_IFCHR | 0666;
+    st->st_uid = 0;
+    st->st_gid = 0;
+
+    return 0;
+}
+
+static FileSystem devfs = {
+    .name = "devfs",
+    .mount = devfs_mount,
+    .unmount = devfs_unmount,
+    .open = devfs_open,
+    .close = devfs_close,
+    .read = devfs_read,
+    .write = devfs_write,
+    .stat = devfs_stat,
+};
+
+void devfs_init(void) {
+    register_fs(&devfs);
+}
+
+int devfs_register(struct device *dev) {
+    int ret = -1;
+
+    spin_lock(&devfs_lock);
+    for (int i = 0; i < DEVFS_MAX_DEVICES; i++) {
+        if (!devices[i]) {
+            devices[i] = dev;
+            ret = 0;
+            break;
+        }
+    }
+    spin_unlock(&devfs_lock);
+
+    return ret;
+}
@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef DEVFS_H
+#define DEVFS_H
+
+#include "../vfs/vfs.h"
+
+#define DEVFS_MAX_DEVICES 16
+
+// A character device, reached through its path under /dev
+struct device {
+    const char *path;                                     // e.g. "/dev/input"
+    int (*open)(int flags);                               // 0 to allow it
+    ssize_t (*read)(void *buf, size_t size, int flags);
+    ssize_t (*write)(const void *buf, size_t size, int flags);
+    void (*release)(void);
+};
+
+void devfs_init(void);
+int devfs_register(struct device *dev);
+
+#endif // DEVFS_H
@@ -11,6 +11,9 @@
 #include <stddef.h>
 #include "../../kernel/string.h"
 #include "vfs.h"
+#include "../../kernel/spinlock.h"
+#include "../../kernel/rcu.h"
+#include "../../kernel/trace.h"
 
 #define MAX_FILES 100000
 FileDescriptor open_files[MAX_FILES];
@@ -18,45 +21,115 @@ FileDescriptor open_files[MAX_FILES];
 #define MAX_FS 4
 FileSystem *registered_fs[MAX_FS];
 
+/*
+ * registered_fs is read on every open and stat but only written when a
+ * filesystem registers, so readers walk it under RCU and only writers
+ * take fs_lock. Allocating a descriptor can scan all of open_files with
+ * it held, so it's an MCS lock and waiters spin on their own node.
+ */
+static DEFINE_MCS_LOCK(fs_lock);
+
 void register_fs(FileSystem *fs) {
+    mcs_node_t node;
+
+    mcs_lock(&fs_lock, &node);
     for (int i = 0; i < MAX_FS; i++) {
         if (!registered_fs[i]) {
-            registered_fs[i] = fs;
-            return;
+            rcu_assign_pointer(registered_fs[i], fs);
+            break;
+        }
+    }
+    mcs_unlock(&fs_lock, &node);
+}
+
+int vfs_alloc_fd(FileSystem *fs, void *private_data, int flags) {
+    int fd = -1;
+    mcs_node_t node;
+
+    mcs_lock(&fs_lock, &node);
+    for (int i = 0; i < MAX_FILES; i++) {
+        if (!open_files[i].fs) {
+            open_files[i].fd = i;
+            open_files[i].fs = fs;
+            open_files[i].private_data = private_data;
+            open_files[i].flags = flags;
+            fd = i;
+            break;
         }
     }
+    mcs_unlock(&fs_lock, &node);
+
+    return fd;
+}
+
+FileDescriptor *vfs_get_fd(int fd) {
+    if (fd < 0 || fd >= MAX_FILES || !open_files[fd].fs) {
+        return NULL;
+    }
+
+    return &open_files[fd];
+}
+
+// Must be called inside rcu_read_lock()
+static FileSystem *get_fs(int i) {
+    return rcu_dereference(registered_fs[i]);
 }
 
 int vfs_mount(const char *fs_name, const char *device, void* unused1, void* unused2) {
+    int result = -1; // FS not found
+
+    rcu_read_lock();
     for (int i = 0; i < MAX_FS; i++) {
-        if (registered_fs[i] && my_strcmp(registered_fs[i]->name, fs_name) == 0) {
-            return registered_fs[i]->mount(device);
+        FileSystem *fs = get_fs(i);
+        if (fs && my_strcmp(fs->name, fs_name) == 0) {
+            result = fs->mount(device);
+            break;
         }
     }
-    return -1; // FS not found
+    rcu_read_unlock();
+    return result;
 }
 
 int vfs_open(const char *path, int flags, void* unused1, void* unused2) {
+    int result = -1; // File not found
+
+    rcu_read_lock();
     for (int i = 0; i < MAX_FS; i++) {
-        if (registered_fs[i]) {
-            int fd = registered_fs[i]->open(path, flags);
+        FileSystem *fs = get_fs(i);
+        if (fs) {
+            int fd = fs->open(path, flags);
             if (fd >= 0) {
-                open_files[fd].fs = registered_fs[i];
-                return fd;
+                open_files[fd].fs = fs;
+                result = fd;
+                break;
             }
         }
     }
-    return -1; // File not found
+    rcu_read_unlock();
+    trace_vfs_open(result, path);
+    return result;
 }
 
 ssize_t vfs_read(int fd, void *buf, size_t size, void* unused1) {
-    if (fd < 0 || fd >= MAX_FILES || !open_files[fd].fs) return -1;
-    return open_files[fd].fs->read(fd, buf, size);
+    ssize_t ret = -1;
+
+    if (fd >= 0 && fd < MAX_FILES && open_files[fd].fs) {
+        ret = open_files[fd].fs->read(fd, buf, size);
+    }
+
+    trace_vfs_read(fd, size, ret);
+    return ret;
 }
 
 ssize_t vfs_write(int fd, const void *buf, size_t size, void* unused1) {
-    if (fd < 0 || fd >= MAX_FILES || !open_files[fd].fs) return -1;
-    return open_files[fd].fs->write(fd, buf, size);
+    ssize_t ret = -1;
+
+    if (fd >= 0 && fd < MAX_FILES && open_files[fd].fs) {
+        ret = open_files[fd].fs->write(fd, buf, size);
+    }
+
+    trace_vfs_write(fd, size, ret);
+    return ret;
 }
 
 int vfs_close(int fd, void* unused1, void* unused2, void* unused3) {
@@ -67,14 +140,17 @@ int vfs_close(int fd, void* unused1, void* unused2, void* unused3) {
 }
 
 int vfs_stat(const char *path, struct stat *st, void* unused1, void* unused2) {
+    int result = -1;
+
     // Check each registered filesystem
+    rcu_read_lock();
     for (int i = 0; i < MAX_FS; i++) {
-        if (registered_fs[i]) {
-            int result = registered_fs[i]->stat(path, st);
-            if (result == 0) {
-                return 0;
-            }
+        FileSystem *fs = get_fs(i);
+        if (fs && fs->stat(path, st) == 0) {
+            result = 0;
+            break;
         }
     }
-    return -1;
+    rcu_read_unlock();
+    return result;
 }
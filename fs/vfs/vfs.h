@@ -7,6 +7,10 @@
 
 typedef int ssize_t;
 
+#define O_NONBLOCK 0x800  // Reads that would block return 0 instead
+
+#define S_IFCHR 0020000   // Character device
+
 struct stat {
     size_t st_size;  // File size in bytes
     unsigned int st_mode;  // File permissions (you can use `S_IFREG`, `S_IFDIR` for regular files, directories, etc.)
@@ -29,10 +33,15 @@ typedef struct FileDescriptor {
     int fd;
     FileSystem *fs;
     void *private_data; // FS-specific file data (like inode pointer)
+    int flags;          // As passed to open
 } FileDescriptor;
 
 void register_fs(FileSystem *fs);
 
+// For filesystems that don't number their own files, -1 if none are free
+int vfs_alloc_fd(FileSystem *fs, void *private_data, int flags);
+FileDescriptor *vfs_get_fd(int fd);
+
 int vfs_mount(const char *fs_name, const char *device, void* unused1, void* unused2);
 
 int vfs_open(const char *path, int flags, void* unused1, void* unused2);
@@ -18,12 +18,69 @@
 #include "../kernel/panic.h"
 #include "../drivers/vga.h"
 #include "../drivers/pci.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/math64.h"
+#include "../kernel/rcu.h"
+#include "../kernel/tsc.h"
+#include "../fs/vfs/vfs.h"
+#include "../kernel/boottime.h"
+#include "../kernel/profile.h"
+#include "../kernel/time.h"
+#include "../kernel/trace.h"
+#include "../kernel/cputime.h"
+#include "../kernel/process.h"
+#include "../kernel/syscall_dispatcher.h"
+#include "../kernel/irqstat.h"
+#include "../kernel/schedstat.h"
+#include "../kernel/printk.h"
+#include "../kernel/softirq.h"
+#include "../drivers/mouse.h"
+#include "../drivers/input.h"
+#include "../drivers/serial.h"
+#include "../drivers/console.h"
+#include "../drivers/ps2_keyboard.h"
 
 const char *build_date = __DATE__;    // Compile date
 const char *build_time = __TIME__;    // Compile time
 
 void print(const char *str);
 
+// Print a string left-justified in a column of the given width
+static void print_column(const char *str, int width) {
+    print(str);
+    for (int len = my_strlen(str); len < width; len++) {
+        print(" ");
+    }
+}
+
+static void print_u32_column(uint32_t num, int width) {
+    char buffer[12];
+    itoa(num, buffer, 10);
+    print_column(buffer, width);
+}
+
+static void print_int(int num) {
+    if (num < 0) {
+        print("-");
+        print_u32_column(-(uint32_t)num, 0);
+        return;
+    }
+
+    print_u32_column(num, 0);
+}
+
+static void print_u64_column(uint64_t num, int width) {
+    char buffer[21];
+    int i = sizeof(buffer) - 1;
+    buffer[i] = '\0';
+    do {
+        uint32_t digit;
+        num = div_u64_rem(num, 10, &digit);
+        buffer[--i] = '0' + digit;
+    } while (num != 0);
+    print_column(&buffer[i], width);
+}
+
 void shell_help() {
     print("\n");
     print("Available commands:\n");
@@ -35,6 +92,19 @@ void shell_help() {
     print("builddate - Print build date and time\n");
     print("mode13h - Switch to graphics mode 13h\n");
     print("scan - Scan PCI bus for devices\n");
+    print("lockstat [on|off|reset] - Show or control lock statistics\n");
+    print("rcubench - Compare RCU reads against spinlock reads\n");
+    print("boottime [log] - Show boot phase timings or the boot log\n");
+    print("prof start [hz] [-g]|stop|dump|reset - Sampling profiler, dumps to COM1\n");
+    print("trace start|stop [event|all], dump, reset - Event tracing, dumps to COM1\n");
+    print("ps - List processes with their CPU time\n");
+    print("sysstat [reset] - Syscall counts and latency histograms\n");
+    print("irqstat [reset] - Interrupt counts, handler time and tick latency\n");
+    print("schedstat [reset] - Wake to run latency and run queue length\n");
+    print("mouse - Mouse position and packet counters\n");
+    print("evtest [count] - Print events from /dev/input\n");
+    print("serial [baud] - COM1 counters, or change its baud rate\n");
+    print("dmesg [level] - Kernel log, up to the given level\n");
 }
 
 void shell_echo(const char *message) {
@@ -44,10 +114,7 @@ void shell_echo(const char *message) {
 }
 
 void shell_clear() {
-    // This clears the screen by printing a ton of blank lines
-    for (int i = 0; i < 25; ++i) {
-        print("\n");
-    }
+    console_clear();
 }
 
 void shell_panic() {
@@ -70,6 +137,7 @@ void shell_graphics() {
     print("Switching graphics mode...\n");
     set_mode_13h();
     draw_rectangle(110, 75, 100, 50, 4);
+    graphics_flush();
 }
 
 void shell_scan() {
@@ -272,15 +340,587 @@ double shell_calculate(const char *args) {
     }
 }
 
+void shell_lockstat(const char *args) {
+    print("\n");
+
+    if (my_strcmp(args, "on") == 0) {
+        lockstat_enabled = 1;
+        print("Lock statistics enabled.\n");
+        return;
+    } else if (my_strcmp(args, "off") == 0) {
+        lockstat_enabled = 0;
+        print("Lock statistics disabled.\n");
+        return;
+    } else if (my_strcmp(args, "reset") == 0) {
+        lockstat_reset();
+        print("Lock statistics reset.\n");
+        return;
+    }
+
+    if (!lockstat_enabled) {
+        print("Lock statistics are off, use 'lockstat on'.\n");
+    }
+
+    print_column("lock", 16);
+    print_column("acquired", 11);
+    print_column("contended", 11);
+    print_column("wait cycles", 16);
+    print("max wait\n");
+
+    for (struct lock_stat *stat = lockstat_first(); stat; stat = stat->next) {
+        print_column(stat->name, 16);
+        print_u32_column(stat->acquisitions, 11);
+        print_u32_column(stat->contentions, 11);
+        print_u64_column(stat->wait_cycles, 16);
+        print_u64_column(stat->max_wait, 0);
+        print("\n");
+    }
+}
+
+#define RCUBENCH_ITERATIONS 100000
+
+extern FileSystem *registered_fs[];
+static DEFINE_SPINLOCK(rcubench_lock);
+
+// Time the same table lookup under rcu_read_lock() and under a spinlock
+void shell_rcubench() {
+    FileSystem *volatile sink;
+    uint64_t start, rcu_cycles, lock_cycles;
+
+    print("\n");
+
+    start = rdtsc();
+    for (int i = 0; i < RCUBENCH_ITERATIONS; i++) {
+        rcu_read_lock();
+        sink = rcu_dereference(registered_fs[0]);
+        rcu_read_unlock();
+    }
+    rcu_cycles = rdtsc() - start;
+
+    start = rdtsc();
+    for (int i = 0; i < RCUBENCH_ITERATIONS; i++) {
+        spin_lock(&rcubench_lock);
+        sink = registered_fs[0];
+        spin_unlock(&rcubench_lock);
+    }
+    lock_cycles = rdtsc() - start;
+
+    (void)sink;
+
+    print_column("reader", 10);
+    print_column("total cycles", 16);
+    print("cycles/read\n");
+    print_column("rcu", 10);
+    print_u64_column(rcu_cycles, 16);
+    print_u64_column(div_u64(rcu_cycles, RCUBENCH_ITERATIONS), 0);
+    print("\n");
+    print_column("spinlock", 10);
+    print_u64_column(lock_cycles, 16);
+    print_u64_column(div_u64(lock_cycles, RCUBENCH_ITERATIONS), 0);
+    print("\n");
+}
+
 extern void jump_usermode(void);
 
+void shell_boottime(const char *args) {
+    print("\n");
+
+    if (my_strcmp(args, "log") == 0) {
+        print(boot_log());
+        return;
+    }
+
+    boottime_report(print);
+}
+
+// Parse a decimal number, returns fallback if there isn't one
+static uint32_t parse_u32(const char *str, uint32_t fallback) {
+    uint32_t num = 0;
+
+    if (*str < '0' || *str > '9') {
+        return fallback;
+    }
+    while (*str >= '0' && *str <= '9') {
+        num = num * 10 + (*str++ - '0');
+    }
+
+    return num;
+}
+
+void shell_prof(const char *args) {
+    print("\n");
+
+    if (my_strcmp(args, "stop") == 0) {
+        prof_stop();
+        print("Profiler stopped.\n");
+        return;
+    } else if (my_strcmp(args, "reset") == 0) {
+        prof_reset();
+        print("Profile samples cleared.\n");
+        return;
+    } else if (my_strcmp(args, "dump") == 0) {
+        prof_dump_serial();
+        print_u32_column(prof_nr_samples(), 0);
+        print(" samples written to COM1, run scripts/profile.py on the capture.\n");
+        return;
+    } else if (args[0] == 's' && args[1] == 't' && args[2] == 'a' &&
+               args[3] == 'r' && args[4] == 't') {
+        const char *opt = args + 5;
+        int callchain = 0;
+        uint32_t hz;
+
+        while (*opt == ' ') {
+            opt++;
+        }
+        hz = parse_u32(opt, HZ);
+        while (*opt >= '0' && *opt <= '9') {
+            opt++;
+        }
+        while (*opt == ' ') {
+            opt++;
+        }
+        if (my_strcmp(opt, "-g") == 0) {
+            callchain = 1;
+        }
+
+        if (prof_start(hz, callchain) != 0) {
+            print("prof: rate must be between 1 and the tick rate\n");
+            return;
+        }
+        print("Profiling at ");
+        print_u32_column(prof_rate(), 0);
+        print(callchain ? " Hz with call chains.\n" : " Hz.\n");
+        return;
+    }
+
+    print(prof_running ? "Profiler running, " : "Profiler stopped, ");
+    print_u32_column(prof_nr_samples(), 0);
+    print(" samples, ");
+    print_u32_column(prof_nr_dropped(), 0);
+    print(" dropped.\n");
+}
+
+void shell_trace(const char *args) {
+    const char *event;
+    int enable;
+
+    print("\n");
+
+    if (my_strcmp(args, "dump") == 0) {
+        uint32_t records = trace_nr_records();
+        trace_dump_serial();
+        print_u32_column(records, 0);
+        print(" records written to COM1, tracing stopped.\n");
+        return;
+    } else if (my_strcmp(args, "reset") == 0) {
+        trace_reset();
+        print("Trace buffers cleared.\n");
+        return;
+    } else if (args[0] == 's' && args[1] == 't' && args[2] == 'a' &&
+               args[3] == 'r' && args[4] == 't') {
+        enable = 1;
+        event = args + 5;
+    } else if (args[0] == 's' && args[1] == 't' && args[2] == 'o' && args[3] == 'p') {
+        enable = 0;
+        event = args + 4;
+    } else {
+        for (int i = 0; i < TRACE_NR_EVENTS; i++) {
+            print_column(trace_event_name(i), 16);
+            print(trace_event_enabled(i) ? "on\n" : "off\n");
+        }
+        print_u32_column(trace_nr_records(), 0);
+        print(" records buffered, ");
+        print_u32_column(trace_nr_lost(), 0);
+        print(" overwritten.\n");
+        return;
+    }
+
+    while (*event == ' ') {
+        event++;
+    }
+    if (*event == '\0') {
+        event = "all";
+    }
+
+    if (trace_set_event(event, enable) != 0) {
+        print("trace: unknown event\n");
+        return;
+    }
+    print(enable ? "Tracing " : "Stopped tracing ");
+    print(event);
+    print(".\n");
+}
+
+// Times in milliseconds
+static void print_cputime_row(int pid, const char *state, const struct task_cputime *ct) {
+    print_u32_column(pid, 6);
+    print_column(state, 11);
+    print_u64_column(tsc_khz ? div_u64(ct->utime, tsc_khz) : 0, 10);
+    print_u64_column(tsc_khz ? div_u64(ct->stime, tsc_khz) : 0, 10);
+    print_u64_column(tsc_khz ? div_u64(ct->itime, tsc_khz) : 0, 10);
+    print_u32_column(ct->nvcsw, 8);
+    print_u32_column(ct->nivcsw, 0);
+    print("\n");
+}
+
+void shell_ps() {
+    static const char *states[] = { "running", "waiting", "terminated" };
+
+    print("\n");
+    print_column("PID", 6);
+    print_column("STATE", 11);
+    print_column("USER ms", 10);
+    print_column("SYS ms", 10);
+    print_column("IRQ ms", 10);
+    print_column("VCSW", 8);
+    print("IVCSW\n");
+
+    // Time spent with no process current, i.e. the kernel and gash
+    print_cputime_row(0, "kernel", cputime_kernel());
+
+    rcu_read_lock();
+    pcb_t *head = rcu_dereference(process_queue);
+    pcb_t *pcb = head;
+    if (pcb) {
+        do {
+            print_cputime_row(pcb->pid, pcb->state <= PROCESS_TERMINATED ? states[pcb->state] : "?",
+                              &pcb->cputime);
+            pcb = rcu_dereference(pcb->next);
+        } while (pcb && pcb != head);
+    }
+    rcu_read_unlock();
+}
+
+void shell_sysstat(const char *args) {
+    struct syscall_stat stat;
+
+    print("\n");
+
+    if (my_strcmp(args, "reset") == 0) {
+        syscall_stats_reset();
+        print("Syscall statistics reset.\n");
+        return;
+    }
+
+    print_column("syscall", 15);
+    print_column("calls", 9);
+    print_column("errors", 9);
+    print_column("avg cyc", 11);
+    print("max cyc\n");
+
+    for (int nr = 0; nr < SYSCALL_TABLE_SIZE; nr++) {
+        syscall_stats_sum(nr, &stat);
+        if (!stat.calls) {
+            continue;
+        }
+
+        print_column(syscall_name(nr), 15);
+        print_u32_column(stat.calls, 9);
+        print_u32_column(stat.errors, 9);
+        print_u64_column(div_u64(stat.cycles, stat.calls), 11);
+        print_u64_column(stat.max_cycles, 0);
+        print("\n");
+
+        // Nonzero buckets as log2(cycles):count
+        print("  ");
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (stat.hist[i]) {
+                print_u32_column(i, 0);
+                print(":");
+                print_u32_column(stat.hist[i], 0);
+                print(" ");
+            }
+        }
+        print("\n");
+    }
+
+    print_u32_column(syscall_stats_invalid(), 0);
+    print(" calls with an invalid number.\n");
+}
+
+static const char *vector_name(int vector) {
+    switch (vector) {
+        case 0x08: return "double fault";
+        case 0x0D: return "GPF";
+        case 0x20: return "timer";
+        case 0x21: return "keyboard";
+        case 0x24: return "serial";
+        case 0x2C: return "mouse";
+        case 0x80: return "syscall";
+        case 0xFF: return "spurious";
+        default:   return "";
+    }
+}
+
+void shell_irqstat(const char *args) {
+    struct irq_stat stat;
+    struct irq_latency lat;
+    char hex[12];
+
+    print("\n");
+
+    if (my_strcmp(args, "reset") == 0) {
+        irqstat_reset();
+        print("Interrupt statistics reset.\n");
+        return;
+    }
+
+    print_column("vec", 5);
+    print_column("source", 14);
+    print_column("count", 11);
+    print_column("avg cyc", 11);
+    print("max cyc\n");
+
+    for (int vector = 0; vector < NR_VECTORS; vector++) {
+        irqstat_sum(vector, &stat);
+        if (!stat.count) {
+            continue;
+        }
+
+        itoa(vector, hex, 16);
+        print_column(hex, 5);
+        print_column(vector_name(vector), 14);
+        print_u32_column(stat.count, 11);
+        print_u64_column(div_u64(stat.cycles, stat.count), 11);
+        print_u64_column(stat.max_cycles, 0);
+        print("\n");
+    }
+
+    print("Softirqs:");
+    for (int nr = 0; nr < NR_SOFTIRQS; nr++) {
+        print(" ");
+        print(softirq_name(nr));
+        print(" ");
+        print_u32_column(softirq_count(nr), 0);
+    }
+    print("\n");
+
+    print("Keyboard characters dropped, tty not reading: ");
+    print_u32_column(ps2_keyboard_dropped(), 0);
+    print("\n");
+
+    irqstat_latency(&lat);
+    if (!lat.samples) {
+        print("No timer latency samples.\n");
+        return;
+    }
+
+    print("Timer latency, cycles past the due time: avg ");
+    print_u64_column(div_u64(lat.total, lat.samples), 0);
+    print(", max ");
+    print_u64_column(lat.max, 0);
+    print("\n  ");
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        if (lat.hist[i]) {
+            print_u32_column(i, 0);
+            print(":");
+            print_u32_column(lat.hist[i], 0);
+            print(" ");
+        }
+    }
+    print("\n");
+}
+
+#define SCHEDSTAT_SHOWN 32  // Run queue samples to print
+
+void shell_schedstat(const char *args) {
+    struct sched_latency lat;
+    uint16_t samples[SCHEDSTAT_SHOWN];
+    uint64_t worst = 0;
+    int count;
+
+    print("\n");
+
+    if (my_strcmp(args, "reset") == 0) {
+        schedstat_reset();
+        print("Scheduler statistics reset.\n");
+        return;
+    }
+
+    print_column("class", 11);
+    print_column("runs", 9);
+    print_column("avg cyc", 11);
+    print("max cyc\n");
+
+    for (int class = 0; class < SCHED_NR_WAKE; class++) {
+        schedstat_latency(class, &lat);
+        if (!lat.count) {
+            continue;
+        }
+        if (lat.max > worst) {
+            worst = lat.max;
+        }
+
+        print_column(schedstat_class_name(class), 11);
+        print_u32_column(lat.count, 9);
+        print_u64_column(div_u64(lat.total, lat.count), 11);
+        print_u64_column(lat.max, 0);
+        print("\n  ");
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            if (lat.hist[i]) {
+                print_u32_column(i, 0);
+                print(":");
+                print_u32_column(lat.hist[i], 0);
+                print(" ");
+            }
+        }
+        print("\n");
+    }
+
+    print("Max scheduling delay: ");
+    print_u64_column(worst, 0);
+    print(" cycles\nRunnable now: ");
+    print_u32_column(nr_running, 0);
+    print(", max sampled: ");
+    print_u32_column(schedstat_rq_max(), 0);
+    print("\nRun queue, oldest first:\n  ");
+
+    count = schedstat_rq_history(samples, SCHEDSTAT_SHOWN);
+    for (int i = 0; i < count; i++) {
+        print_u32_column(samples[i], 0);
+        print(" ");
+    }
+    print("\n");
+}
+
+void shell_mouse() {
+    static MouseState state;
+    struct mouse_stats stats;
+
+    print("\n");
+
+    mouse_update(&state);
+    mouse_get_stats(&stats);
+
+    print("Position ");
+    print_int(state.x);
+    print(",");
+    print_int(state.y);
+    print(" wheel ");
+    print_int(state.z);
+    print(" buttons ");
+    print_u32_column(state.buttons, 0);
+    print(mouse_has_wheel() ? " (wheel mouse)\n" : "\n");
+
+    print("Packets ");
+    print_u32_column(stats.packets, 0);
+    print(", resyncs ");
+    print_u32_column(stats.resyncs, 0);
+    print(", overflows ");
+    print_u32_column(stats.overflows, 0);
+    print(", dropped ");
+    print_u32_column(stats.dropped, 0);
+    print("\n");
+}
+
+#define EVTEST_BATCH 16
+
+// Reads the same way a user program would, a batch per read()
+void shell_evtest(const char *args) {
+    static struct input_event events[EVTEST_BATCH];
+    uint32_t count = parse_u32(args, 20);
+    uint32_t seen = 0;
+    ssize_t len;
+    int fd;
+
+    print("\n");
+
+    fd = vfs_open("/dev/input", 0, NULL, NULL);
+    if (fd < 0) {
+        print("evtest: can't open /dev/input\n");
+        return;
+    }
+
+    print_column("tsc", 18);
+    print_column("type", 6);
+    print_column("code", 6);
+    print("value\n");
+
+    while (seen < count) {
+        len = vfs_read(fd, events, sizeof(events), NULL);
+        if (len <= 0) {
+            break;
+        }
+
+        for (uint32_t i = 0; i < len / sizeof(struct input_event); i++) {
+            print_u64_column(events[i].tsc, 18);
+            print_u32_column(events[i].type, 6);
+            print_u32_column(events[i].code, 6);
+            print_int(events[i].value);
+            print("\n");
+            seen++;
+        }
+    }
+
+    vfs_close(fd, NULL, NULL, NULL);
+
+    print("Dropped ");
+    print_u32_column(input_dropped(), 0);
+    print("\n");
+}
+
+void shell_serial(const char *args) {
+    struct serial_stats stats;
+
+    print("\n");
+
+    if (*args) {
+        if (serial_set_baud(parse_u32(args, 0)) != 0) {
+            print("serial: baud must divide 115200\n");
+            return;
+        }
+    }
+
+    serial_get_stats(&stats);
+
+    print("Baud ");
+    print_u32_column(serial_get_baud(), 0);
+    print(", FIFO ");
+    print_u32_column(serial_fifo_size(), 0);
+    print(" bytes, ");
+    print_u32_column(stats.irqs, 0);
+    print(" interrupts\n");
+
+    print("Sent ");
+    print_u32_column(stats.tx_bytes, 0);
+    print(", writer waits ");
+    print_u32_column(stats.tx_waits, 0);
+    print("\n");
+
+    print("Received ");
+    print_u32_column(stats.rx_bytes, 0);
+    print(", dropped ");
+    print_u32_column(stats.rx_dropped, 0);
+    print(", overruns ");
+    print_u32_column(stats.rx_overruns, 0);
+    print("\n");
+}
+
+void shell_dmesg(const char *args) {
+    static struct log_record rec;
+    static char line[LOG_LINE_MAX + 24];
+    uint32_t level = parse_u32(args, LOG_DEBUG);
+    uint32_t seq = log_first_seq();
+
+    print("\n");
+
+    while (log_read(&seq, &rec)) {
+        if (rec.level <= level) {
+            log_format(&rec, line, sizeof(line));
+            print(line);
+        }
+    }
+}
+
 void shell_usermode() {
    print("\n");
+   cputime_user_enter();
    jump_usermode();
 }
 
 void shell_render() {
     draw_rectangle(50, 75, 100, 50, 1);    
+    graphics_flush();
     print("\n");
     print("GPU render executed.\n");
 }
@@ -335,6 +975,32 @@ void shell_execute_command(const char *command) {
         shell_scan();
     } else if (my_strcmp(command_name, "vendor") == 0) {
         shell_vendor();
+    } else if (my_strcmp(command_name, "lockstat") == 0) {
+        shell_lockstat(args);
+    } else if (my_strcmp(command_name, "rcubench") == 0) {
+        shell_rcubench();
+    } else if (my_strcmp(command_name, "boottime") == 0) {
+        shell_boottime(args);
+    } else if (my_strcmp(command_name, "prof") == 0) {
+        shell_prof(args);
+    } else if (my_strcmp(command_name, "trace") == 0) {
+        shell_trace(args);
+    } else if (my_strcmp(command_name, "ps") == 0) {
+        shell_ps();
+    } else if (my_strcmp(command_name, "sysstat") == 0) {
+        shell_sysstat(args);
+    } else if (my_strcmp(command_name, "irqstat") == 0) {
+        shell_irqstat(args);
+    } else if (my_strcmp(command_name, "schedstat") == 0) {
+        shell_schedstat(args);
+    } else if (my_strcmp(command_name, "mouse") == 0) {
+        shell_mouse();
+    } else if (my_strcmp(command_name, "evtest") == 0) {
+        shell_evtest(args);
+    } else if (my_strcmp(command_name, "serial") == 0) {
+        shell_serial(args);
+    } else if (my_strcmp(command_name, "dmesg") == 0) {
+        shell_dmesg(args);
     } else if (my_strcmp(command_name, "mandel") == 0) {
         shell_mandelbrot();
     } else if (my_strcmp(command_name, "calculate") == 0) {
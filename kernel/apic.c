@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/apic.c
+ *
+ * Local APIC and I/O APIC. The local APIC timer replaces the PIT as
+ * the scheduling tick, and interrupts are acknowledged with a single
+ * MMIO write instead of a port write to the 8259.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "apic.h"
+#include "cpuid.h"
+#include "io.h"
+#include "msr.h"
+#include "percpu.h"
+#include "pit.h"
+#include "print.h"
+#include "tsc.h"
+#include "math64.h"
+
+// Local APIC registers (byte offsets)
+#define LAPIC_ID         0x020
+#define LAPIC_TPR        0x080
+#define LAPIC_EOI        0x0B0
+#define LAPIC_SVR        0x0F0
+#define LAPIC_LVT_TIMER  0x320
+#define LAPIC_LVT_LINT0  0x350
+#define LAPIC_LVT_LINT1  0x360
+#define LAPIC_LVT_ERROR  0x370
+#define LAPIC_TIMER_ICR  0x380  // Initial count
+#define LAPIC_TIMER_CCR  0x390  // Current count
+#define LAPIC_TIMER_DCR  0x3E0  // Divide configuration
+
+#define LAPIC_SVR_ENABLE       0x100
+#define LAPIC_LVT_MASKED       0x10000
+#define LAPIC_TIMER_PERIODIC   0x20000
+#define LAPIC_TIMER_DEADLINE   0x40000
+#define LAPIC_TIMER_DIV_16     0x3
+#define APIC_BASE_MSR_ENABLE   0x800
+
+// I/O APIC
+#define IOAPIC_DEFAULT_BASE 0xFEC00000
+#define IOAPIC_REGSEL       0x00
+#define IOAPIC_WINDOW       0x10
+#define IOAPIC_VERSION      0x01
+#define IOAPIC_REDTBL(n)    (0x10 + 2 * (n))
+#define IOAPIC_MASKED       0x10000
+
+int apic_enabled = 0;
+int lapic_tsc_deadline = 0;
+uint32_t lapic_timer_khz = 0;
+uint64_t lapic_next_deadline[NR_CPUS];
+
+static volatile uint32_t *lapic_base;
+static volatile uint32_t *ioapic_base = (volatile uint32_t *)IOAPIC_DEFAULT_BASE;
+static uint64_t tsc_per_tick;
+static uint32_t lapic_timer_icr;  // Periodic mode reload value
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return lapic_base[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    lapic_base[reg / 4] = value;
+}
+
+static uint32_t ioapic_read(uint8_t reg) {
+    ioapic_base[IOAPIC_REGSEL / 4] = reg;
+    return ioapic_base[IOAPIC_WINDOW / 4];
+}
+
+static void ioapic_write(uint8_t reg, uint32_t value) {
+    ioapic_base[IOAPIC_REGSEL / 4] = reg;
+    ioapic_base[IOAPIC_WINDOW / 4] = value;
+}
+
+uint32_t lapic_id(void) {
+    return lapic_read(LAPIC_ID) >> 24;
+}
+
+static void pic_disable(void) {
+    outb(0x21, 0xFF);  // Mask all IRQs on master PIC
+    outb(0xA1, 0xFF);  // Mask all IRQs on slave PIC
+}
+
+// Count APIC timer ticks over a PIT channel 2 window
+static int lapic_timer_calibrate(void) {
+    uint32_t loops = 0;
+
+    lapic_write(LAPIC_TIMER_DCR, LAPIC_TIMER_DIV_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+
+    pit_oneshot_start(CALIBRATE_MS);
+    lapic_write(LAPIC_TIMER_ICR, 0xFFFFFFFF);
+
+    while (!pit_oneshot_expired()) {
+        if (++loops > CALIBRATE_MAX_LOOPS) {
+            lapic_write(LAPIC_TIMER_ICR, 0);
+            return -1;
+        }
+    }
+
+    uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CCR);
+    lapic_write(LAPIC_TIMER_ICR, 0);
+
+    lapic_timer_khz = elapsed / CALIBRATE_MS;
+
+    return lapic_timer_khz ? 0 : -1;
+}
+
+int lapic_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & CPUID_1_EDX_APIC) || !(edx & CPUID_1_EDX_MSR)) {
+        return -1;
+    }
+
+    // Without an I/O APIC the devices would still need the 8259, so
+    // stay on the legacy controller altogether in that case
+    if (ioapic_read(IOAPIC_VERSION) == 0xFFFFFFFF) {
+        return -1;
+    }
+
+    uint64_t base = rdmsr(MSR_IA32_APIC_BASE);
+    wrmsr(MSR_IA32_APIC_BASE, base | APIC_BASE_MSR_ENABLE);
+    lapic_base = (volatile uint32_t *)(uint32_t)(base & 0xFFFFF000);
+
+    // Accept all priorities, mask the local lines and the error LVT
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_LVT_LINT0, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_LVT_LINT1, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_LVT_ERROR, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+
+    // Software-enable the APIC
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | SPURIOUS_VECTOR);
+
+    // Mask every I/O APIC pin until a driver asks for it
+    uint32_t pins = ((ioapic_read(IOAPIC_VERSION) >> 16) & 0xFF) + 1;
+    for (uint32_t pin = 0; pin < pins; pin++) {
+        ioapic_write(IOAPIC_REDTBL(pin), IOAPIC_MASKED);
+        ioapic_write(IOAPIC_REDTBL(pin) + 1, 0);
+    }
+
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    lapic_tsc_deadline = (ecx & CPUID_1_ECX_TSC_DEADLINE) && tsc_khz != 0;
+
+    // No tick without a known timer rate, leave the 8259 and PIT in charge
+    if (!lapic_tsc_deadline && lapic_timer_calibrate()) {
+        lapic_write(LAPIC_SVR, SPURIOUS_VECTOR);
+        return -1;
+    }
+
+    pic_disable();
+    apic_enabled = 1;
+
+    return 0;
+}
+
+void lapic_timer_init(uint32_t hz) {
+    int cpu = smp_processor_id();
+
+    if (lapic_tsc_deadline) {
+        tsc_per_tick = div_u64((uint64_t)tsc_khz * 1000, hz);
+
+        lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_DEADLINE | TIMER_VECTOR);
+        lapic_next_deadline[cpu] = rdtsc() + tsc_per_tick;
+        wrmsr(MSR_IA32_TSC_DEADLINE, lapic_next_deadline[cpu]);
+        return;
+    }
+
+    if (tsc_khz) {
+        tsc_per_tick = div_u64((uint64_t)tsc_khz * 1000, hz);
+        lapic_next_deadline[cpu] = rdtsc() + tsc_per_tick;
+    }
+
+    lapic_write(LAPIC_TIMER_DCR, LAPIC_TIMER_DIV_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | TIMER_VECTOR);
+    lapic_timer_icr = lapic_timer_khz * 1000 / hz;
+    lapic_write(LAPIC_TIMER_ICR, lapic_timer_icr);
+}
+
+int lapic_timer_latency(uint64_t *cycles) {
+    if (!tsc_khz) {
+        return -1;
+    }
+
+    if (lapic_tsc_deadline) {
+        uint64_t now = rdtsc();
+        uint64_t deadline = lapic_next_deadline[smp_processor_id()];
+
+        *cycles = now > deadline ? now - deadline : 0;
+        return 0;
+    }
+
+    // Periodic mode reloads on expiry, the count since then is the delay
+    if (lapic_timer_icr && lapic_timer_khz) {
+        uint32_t elapsed = lapic_timer_icr - lapic_read(LAPIC_TIMER_CCR);
+        *cycles = div_u64((uint64_t)elapsed * tsc_khz, lapic_timer_khz);
+        return 0;
+    }
+
+    return -1;
+}
+
+void lapic_timer_rearm(void) {
+    int cpu = smp_processor_id();
+
+    if (!tsc_per_tick) {
+        return;
+    }
+
+    lapic_next_deadline[cpu] += tsc_per_tick;
+
+    if (lapic_tsc_deadline) {
+        // If we fell more than a tick behind, don't fire a burst to catch up
+        uint64_t now = rdtsc();
+        if (lapic_next_deadline[cpu] < now) {
+            lapic_next_deadline[cpu] = now + tsc_per_tick;
+        }
+        wrmsr(MSR_IA32_TSC_DEADLINE, lapic_next_deadline[cpu]);
+    }
+}
+
+void irq_eoi(uint8_t irq) {
+    if (apic_enabled) {
+        lapic_write(LAPIC_EOI, 0);
+        return;
+    }
+
+    if (irq >= 8) {
+        outb(0xA0, 0x20);  // Slave PIC
+    }
+    outb(0x20, 0x20);
+}
+
+void irq_unmask(uint8_t irq) {
+    if (apic_enabled) {
+        // ISA IRQs are identity-mapped onto I/O APIC pins, except IRQ 0
+        // which sits on pin 2, but the PIT is never routed here anyway
+        ioapic_write(IOAPIC_REDTBL(irq) + 1, lapic_id() << 24);
+        ioapic_write(IOAPIC_REDTBL(irq), IRQ_BASE_VECTOR + irq);
+        return;
+    }
+
+    uint16_t port = 0x21;
+    if (irq >= 8) {
+        outb(0x21, inb(0x21) & ~(1 << 2));  // The slave hangs off IRQ2
+        port = 0xA1;
+        irq -= 8;
+    }
+    outb(port, inb(port) & ~(1 << irq));
+}
@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef APIC_H
+#define APIC_H
+
+#include <stdint.h>
+
+#define TIMER_VECTOR    0x20  // Same vector the PIT used, the PIC is remapped there
+#define IRQ_BASE_VECTOR 0x20  // ISA IRQ n is delivered on vector 0x20 + n
+#define SPURIOUS_VECTOR 0xFF
+
+extern int apic_enabled;              // Local and I/O APIC in use, 8259 masked
+extern int lapic_tsc_deadline;        // Timer runs in TSC-deadline mode
+extern uint32_t lapic_timer_khz;      // APIC timer ticks per millisecond
+extern uint64_t lapic_next_deadline[];  // TSC value the next tick is due at
+
+// Bring up the local APIC and I/O APIC, returns 0 on success
+int lapic_init(void);
+
+// Start this CPU's scheduling tick at hz interrupts per second
+void lapic_timer_init(uint32_t hz);
+
+// Program the next tick, called from the timer interrupt
+void lapic_timer_rearm(void);
+
+uint32_t lapic_id(void);
+
+// TSC cycles since the tick was due, call before lapic_timer_rearm()
+int lapic_timer_latency(uint64_t *cycles);
+
+// Acknowledge an interrupt, on whichever controller is in use
+void irq_eoi(uint8_t irq);
+
+// Let an ISA IRQ line through to the CPU
+void irq_unmask(uint8_t irq);
+
+#endif // APIC_H
@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/boottime.c
+ *
+ * Boot phase timing and the boot log.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "boottime.h"
+#include "math64.h"
+#include "kprintf.h"
+#include "printk.h"
+#include "tsc.h"
+
+#define BOOT_MAX_PHASES 32
+#define BOOT_LOG_SIZE   4096
+
+int quiet_boot = 1;  // Set to 0 to watch every init step go by
+
+struct boot_phase {
+    const char *name;
+    uint64_t end;  // TSC when the phase finished
+};
+
+static uint64_t boot_tsc;
+static struct boot_phase phases[BOOT_MAX_PHASES];
+static int nr_phases;
+
+static char log_buffer[BOOT_LOG_SIZE];
+static uint32_t log_len;
+
+void boot_start(void) {
+    boot_tsc = rdtsc();
+}
+
+uint64_t boot_start_tsc(void) {
+    return boot_tsc;
+}
+
+void boot_mark(const char *phase) {
+    if (nr_phases < BOOT_MAX_PHASES) {
+        phases[nr_phases].name = phase;
+        phases[nr_phases].end = rdtsc();
+        nr_phases++;
+    }
+}
+
+void boot_print(const char *str) {
+    // Keep what fits, the start of boot is the interesting part
+    for (const char *p = str; *p && log_len < BOOT_LOG_SIZE - 1; p++) {
+        log_buffer[log_len++] = *p;
+    }
+    log_buffer[log_len] = '\0';
+
+    log_puts(LOG_INFO, str);
+}
+
+const char *boot_log(void) {
+    return log_buffer;
+}
+
+// The TSC is calibrated partway through boot, so convert at report time
+static uint64_t cycles_to_us(uint64_t cycles) {
+    return tsc_khz ? div_u64(cycles * 1000, tsc_khz) : 0;
+}
+
+// Each line is formatted first so out() runs once per line, not once per field
+void boottime_report(void (*out)(const char *)) {
+    uint64_t prev = boot_tsc;
+    char line[64];
+
+    if (!tsc_khz) {
+        out("No calibrated TSC, boot timings are unavailable.\n");
+        return;
+    }
+
+    ksnprintf(line, sizeof(line), "%-24s%11s\n", "phase", "us");
+    out(line);
+
+    for (int i = 0; i < nr_phases; i++) {
+        ksnprintf(line, sizeof(line), "%-24s%11llu\n", phases[i].name,
+                  (unsigned long long)cycles_to_us(phases[i].end - prev));
+        out(line);
+        prev = phases[i].end;
+    }
+
+    ksnprintf(line, sizeof(line), "%-24s%11llu\n", "total",
+              (unsigned long long)cycles_to_us(prev - boot_tsc));
+    out(line);
+}
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef BOOTTIME_H
+#define BOOTTIME_H
+
+#include <stdint.h>
+
+extern int quiet_boot;  // Keep init chatter in the boot log instead of on screen
+
+// Take the boot start timestamp, first thing in kernel_main
+void boot_start(void);
+
+// TSC at boot_start(), for anything else that counts from boot
+uint64_t boot_start_tsc(void);
+
+// Record that the named phase just finished
+void boot_mark(const char *phase);
+
+// Into the kernel log at LOG_INFO, which only reaches the screen on a noisy boot
+void boot_print(const char *str);
+
+// Everything boot_print() was given, printed or not
+const char *boot_log(void);
+
+// Write the per-phase timings through out(), a line at a time
+void boottime_report(void (*out)(const char *));
+
+#endif // BOOTTIME_H
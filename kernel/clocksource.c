@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/clocksource.c
+ *
+ * Clocksources, the counters timekeeping is built on.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "clocksource.h"
+#include "cpuid.h"
+#include "math64.h"
+#include "time.h"
+#include "tsc.h"
+
+static struct clocksource *clocksource_list = NULL;
+
+// Pick the largest shift (so the best precision) that keeps mult in 32 bits
+static void clocks_calc_mult(struct clocksource *cs, uint32_t ns_per_unit, uint32_t freq) {
+    for (uint32_t shift = 32; shift > 0; shift--) {
+        uint64_t mult = div_u64((uint64_t)ns_per_unit << shift, freq);
+        if (mult <= 0xFFFFFFFF) {
+            cs->mult = (uint32_t)mult;
+            cs->shift = shift;
+            return;
+        }
+    }
+
+    cs->mult = ns_per_unit / freq;
+    cs->shift = 0;
+}
+
+static void clocksource_enqueue(struct clocksource *cs) {
+    cs->next = clocksource_list;
+    clocksource_list = cs;
+}
+
+void clocksource_register_khz(struct clocksource *cs, uint32_t khz) {
+    clocks_calc_mult(cs, NSEC_PER_MSEC, khz);
+    clocksource_enqueue(cs);
+}
+
+void clocksource_register_hz(struct clocksource *cs, uint32_t hz) {
+    clocks_calc_mult(cs, NSEC_PER_SEC, hz);
+    clocksource_enqueue(cs);
+}
+
+struct clocksource *clocksource_best(void) {
+    struct clocksource *best = clocksource_list;
+
+    for (struct clocksource *cs = clocksource_list; cs; cs = cs->next) {
+        if (cs->rating > best->rating) {
+            best = cs;
+        }
+    }
+
+    return best;
+}
+
+static uint64_t tsc_read(void) {
+    return rdtsc();
+}
+
+static struct clocksource clocksource_tsc = {
+    .name = "tsc",
+    .read = tsc_read,
+    .rating = 300,
+    .vclock_mode = VCLOCK_TSC,
+};
+
+/*
+ * Counts ticks from whichever timer is driving them (local APIC or
+ * PIT), so it's only as fine as 1/HZ. Always there as a last resort.
+ */
+static uint64_t jiffies_read(void) {
+    return jiffies_64;
+}
+
+static struct clocksource clocksource_jiffies = {
+    .name = "jiffies",
+    .read = jiffies_read,
+    .rating = 1,
+    .vclock_mode = VCLOCK_NONE,
+};
+
+void clocksource_init(void) {
+    clocksource_register_hz(&clocksource_jiffies, HZ);
+
+    if (tsc_khz) {
+        uint32_t eax, ebx, ecx, edx;
+
+        // Without an invariant TSC the rate may follow P-states, still
+        // better than the tick but rate it lower
+        cpuid(0x80000000, &eax, &ebx, &ecx, &edx);
+        if (eax >= 0x80000007) {
+            cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        } else {
+            edx = 0;
+        }
+        if (!(edx & (1U << 8))) {
+            clocksource_tsc.rating = 200;
+        }
+
+        clocksource_register_khz(&clocksource_tsc, tsc_khz);
+    }
+}
@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef CLOCKSOURCE_H
+#define CLOCKSOURCE_H
+
+#include <stdint.h>
+
+#define NSEC_PER_USEC 1000U
+#define NSEC_PER_MSEC 1000000U
+#define NSEC_PER_SEC  1000000000U
+
+// How user space can read a clocksource through the time page
+#define VCLOCK_NONE 0  // It can't, use the syscall
+#define VCLOCK_TSC  1
+
+/*
+ * A free-running counter we can build time on. Counts are turned into
+ * nanoseconds with ns = (cycles * mult) >> shift, so no division is
+ * needed on the read side.
+ */
+struct clocksource {
+    const char *name;
+    uint64_t (*read)(void);
+    uint32_t mult;
+    uint32_t shift;
+    int rating;              // Higher is better
+    uint32_t vclock_mode;    // VCLOCK_*
+    struct clocksource *next;
+};
+
+void clocksource_register_khz(struct clocksource *cs, uint32_t khz);
+void clocksource_register_hz(struct clocksource *cs, uint32_t hz);
+
+// Highest rated clocksource registered so far
+struct clocksource *clocksource_best(void);
+
+// Register the built-in sources (TSC, then jiffies as the fallback)
+void clocksource_init(void);
+
+// Convert a cycle delta to nanoseconds, 64x32 bit without overflow
+static inline __attribute__((always_inline))
+uint64_t clocksource_cyc2ns(uint64_t cycles, uint32_t mult, uint32_t shift) {
+    uint64_t low = (uint64_t)(uint32_t)cycles * mult;
+    uint64_t high = (uint64_t)(uint32_t)(cycles >> 32) * mult;
+
+    // shift is at most 32, see clocks_calc_mult()
+    return (low >> shift) + (high << (32 - shift));
+}
+
+#endif // CLOCKSOURCE_H
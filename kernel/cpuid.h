@@ -0,0 +1,21 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef CPUID_H
+#define CPUID_H
+
+#include <stdint.h>
+
+// CPUID leaf 1 feature bits
+#define CPUID_1_EDX_TSC          (1U << 4)
+#define CPUID_1_EDX_MSR          (1U << 5)
+#define CPUID_1_EDX_APIC         (1U << 9)
+#define CPUID_1_EDX_SEP          (1U << 11)
+#define CPUID_1_ECX_TSC_DEADLINE (1U << 24)
+
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx) {
+    asm volatile("cpuid"
+                 : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                 : "a"(leaf), "c"(0));
+}
+
+#endif // CPUID_H
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/cputime.c
+ *
+ * Per-process CPU time accounting from the TSC.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cputime.h"
+#include "irqflags.h"
+#include "math64.h"
+#include "percpu.h"
+#include "process.h"
+#include "syscall_table.h"
+#include "tsc.h"
+
+#define CPUTIME_MAX_DEPTH 8
+
+/*
+ * Each CPU keeps a small stack of states: the bottom is user or system
+ * for the running process, syscalls and interrupts push on top. Time
+ * always goes to the state on top, for whichever process is current.
+ */
+struct cputime_cpu {
+    uint64_t stamp;  // TSC at the last transition
+    int depth;
+    uint8_t state[CPUTIME_MAX_DEPTH];
+    struct task_cputime kernel;  // No current process
+};
+
+static struct cputime_cpu cputime_cpus[NR_CPUS] = {
+    [0 ... NR_CPUS - 1] = { .depth = 1, .state = { CPUTIME_SYSTEM } },
+};
+
+static struct task_cputime *cputime_of(pcb_t *pcb, struct cputime_cpu *cc) {
+    return pcb ? &pcb->cputime : &cc->kernel;
+}
+
+// Entries past the end were never stored, the last one stands in for them
+static int cputime_top(struct cputime_cpu *cc) {
+    return (cc->depth < CPUTIME_MAX_DEPTH ? cc->depth : CPUTIME_MAX_DEPTH) - 1;
+}
+
+// Charge everything since the last stamp to pcb
+static void cputime_charge(struct cputime_cpu *cc, pcb_t *pcb) {
+    uint64_t now = rdtsc();
+    uint64_t delta = cc->stamp ? now - cc->stamp : 0;
+    struct task_cputime *ct = cputime_of(pcb, cc);
+
+    switch (cc->state[cputime_top(cc)]) {
+        case CPUTIME_USER:
+            ct->utime += delta;
+            break;
+        case CPUTIME_IRQ:
+            ct->itime += delta;
+            break;
+        default:
+            ct->stime += delta;
+            break;
+    }
+
+    cc->stamp = now;
+}
+
+void cputime_enter(int state) {
+    uint32_t flags;
+    struct cputime_cpu *cc = &cputime_cpus[smp_processor_id()];
+
+    local_irq_save(flags);
+    cputime_charge(cc, current_process);
+    if (cc->depth < CPUTIME_MAX_DEPTH) {
+        cc->state[cc->depth] = state;
+    }
+    cc->depth++;
+    local_irq_restore(flags);
+}
+
+void cputime_exit(void) {
+    uint32_t flags;
+    struct cputime_cpu *cc = &cputime_cpus[smp_processor_id()];
+
+    local_irq_save(flags);
+    cputime_charge(cc, current_process);
+    if (cc->depth > 1) {
+        cc->depth--;
+    }
+    local_irq_restore(flags);
+}
+
+void cputime_user_enter(void) {
+    uint32_t flags;
+    struct cputime_cpu *cc = &cputime_cpus[smp_processor_id()];
+
+    local_irq_save(flags);
+    cputime_charge(cc, current_process);
+    cc->depth = 1;
+    cc->state[0] = CPUTIME_USER;
+    local_irq_restore(flags);
+}
+
+void cputime_switch(pcb_t *prev, int preempted) {
+    struct cputime_cpu *cc = &cputime_cpus[smp_processor_id()];
+    struct task_cputime *ct = cputime_of(prev, cc);
+
+    cputime_charge(cc, prev);
+
+    /*
+     * The stack belongs to prev. Whatever it pushed (a syscall that ends
+     * in schedule(), an interrupt that preempted it) is never popped on
+     * this CPU, so start the incoming task fresh in the kernel.
+     */
+    cc->depth = 1;
+    cc->state[0] = CPUTIME_SYSTEM;
+
+    if (preempted) {
+        ct->nivcsw++;
+    } else {
+        ct->nvcsw++;
+    }
+}
+
+const struct task_cputime *cputime_kernel(void) {
+    return &cputime_cpus[0].kernel;
+}
+
+void cputime_to_timeval(uint64_t cycles, struct timeval *tv) {
+    uint32_t usec;
+
+    if (!tsc_khz) {
+        tv->tv_sec = 0;
+        tv->tv_usec = 0;
+        return;
+    }
+
+    tv->tv_sec = (int32_t)div_u64_rem(div_u64(cycles * 1000, tsc_khz), 1000000, &usec);
+    tv->tv_usec = (int32_t)usec;
+}
+
+int sys_getrusage(void *who, void *usage, void *unused1, void *unused2) {
+    struct rusage *ru = (struct rusage *)usage;
+    const struct task_cputime *ct;
+
+    if ((uint32_t)who != RUSAGE_SELF || !ru) {
+        return -1;
+    }
+
+    ct = current_process ? &current_process->cputime : cputime_kernel();
+    cputime_to_timeval(ct->utime, &ru->ru_utime);
+    cputime_to_timeval(ct->stime, &ru->ru_stime);
+    cputime_to_timeval(ct->itime, &ru->ru_itime);
+    ru->ru_nvcsw = ct->nvcsw;
+    ru->ru_nivcsw = ct->nivcsw;
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef CPUTIME_H
+#define CPUTIME_H
+
+#include <stdint.h>
+
+// What the CPU is doing on behalf of the current process
+#define CPUTIME_USER   0
+#define CPUTIME_SYSTEM 1
+#define CPUTIME_IRQ    2
+
+// Per-process totals, in TSC cycles
+struct task_cputime {
+    uint64_t utime;
+    uint64_t stime;
+    uint64_t itime;   // Interrupts that arrived while it was running
+    uint32_t nvcsw;   // Gave up the CPU itself
+    uint32_t nivcsw;  // Preempted by the tick
+};
+
+struct timeval {
+    int32_t tv_sec;
+    int32_t tv_usec;
+};
+
+#define RUSAGE_SELF 0
+
+struct rusage {
+    struct timeval ru_utime;
+    struct timeval ru_stime;
+    struct timeval ru_itime;
+    uint32_t ru_nvcsw;
+    uint32_t ru_nivcsw;
+};
+
+/*
+ * Transitions, each charges the cycles since the last one to whatever
+ * the CPU was doing until now. Enter and exit nest.
+ */
+void cputime_enter(int state);
+void cputime_exit(void);
+void cputime_user_enter(void);  // Dropping to ring 3 for good
+
+struct process_control_block;
+
+// At a context switch, before current_process changes
+void cputime_switch(struct process_control_block *prev, int preempted);
+
+// Time charged while no process was current, shown as pid 0
+const struct task_cputime *cputime_kernel(void);
+
+void cputime_to_timeval(uint64_t cycles, struct timeval *tv);
+
+#endif // CPUTIME_H
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/delay.c
+ *
+ * Calibrated delays and polling with a timeout.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "delay.h"
+#include "io.h"
+#include "irqflags.h"
+#include "math64.h"
+#include "time.h"
+#include "tsc.h"
+
+#define US_PER_TICK (1000000 / HZ)
+
+static inline uint64_t ns_to_cycles(uint64_t ns) {
+    return div_u64(ns * tsc_khz, 1000000);
+}
+
+static void delay_cycles(uint64_t cycles) {
+    uint64_t start = rdtsc();
+
+    while (rdtsc() - start < cycles) {
+        cpu_relax();
+    }
+}
+
+// Without a TSC, lean on a write to the POST port taking about 1us
+static void io_delay_us(uint32_t us) {
+    while (us--) {
+        outb(0x80, 0);
+    }
+}
+
+void ndelay(uint32_t ns) {
+    if (tsc_khz) {
+        delay_cycles(ns_to_cycles(ns));
+    } else {
+        io_delay_us((ns + 999) / 1000);
+    }
+}
+
+void udelay(uint32_t us) {
+    if (tsc_khz) {
+        delay_cycles(ns_to_cycles((uint64_t)us * 1000));
+    } else {
+        io_delay_us(us);
+    }
+}
+
+void mdelay(uint32_t ms) {
+    while (ms--) {
+        udelay(1000);
+    }
+}
+
+void poll_timeout_start(struct poll_timeout *pt, uint32_t timeout_us) {
+    pt->left_us = timeout_us;
+    pt->spun_us = 0;
+
+    if (tsc_khz) {
+        pt->start = rdtsc();
+        pt->spin_end = pt->start + ns_to_cycles((uint64_t)POLL_SPIN_US * 1000);
+        pt->deadline = pt->start + ns_to_cycles((uint64_t)timeout_us * 1000);
+
+        // A halt can take a whole tick, past here it would overshoot
+        pt->halt_end = timeout_us > US_PER_TICK
+            ? pt->deadline - ns_to_cycles((uint64_t)US_PER_TICK * 1000)
+            : pt->start;
+    }
+}
+
+int poll_timeout_wait(struct poll_timeout *pt) {
+    // Halting only helps if an interrupt is going to wake us up
+    int can_halt = !irqs_disabled();
+
+    if (tsc_khz) {
+        uint64_t now = rdtsc();
+
+        if (now >= pt->deadline) {
+            return 1;
+        }
+
+        if (now < pt->spin_end || now >= pt->halt_end || !can_halt) {
+            cpu_relax();
+        } else {
+            asm volatile("hlt" : : : "memory");
+        }
+
+        return 0;
+    }
+
+    if (!pt->left_us) {
+        return 1;
+    }
+
+    if (pt->spun_us < POLL_SPIN_US || pt->left_us < US_PER_TICK || !can_halt) {
+        io_delay_us(1);
+        pt->spun_us++;
+        pt->left_us--;
+    } else {
+        // Can't tell how long we were out, assume a whole tick
+        asm volatile("hlt" : : : "memory");
+        pt->left_us = pt->left_us > US_PER_TICK ? pt->left_us - US_PER_TICK : 0;
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef DELAY_H
+#define DELAY_H
+
+#include <stdint.h>
+
+// Busy-wait for a calibrated time, fine for short hardware delays
+void ndelay(uint32_t ns);
+void udelay(uint32_t us);
+void mdelay(uint32_t ms);
+
+// How long poll_until() spins before it starts halting between checks
+#define POLL_SPIN_US 50
+
+struct poll_timeout {
+    uint64_t start;     // TSC when polling started
+    uint64_t spin_end;  // TSC to stop spinning at
+    uint64_t halt_end;  // TSC after which there's no time left to halt
+    uint64_t deadline;  // TSC to give up at
+    uint32_t left_us;   // Budget left when there's no TSC
+    uint32_t spun_us;
+};
+
+void poll_timeout_start(struct poll_timeout *pt, uint32_t timeout_us);
+
+// Wait a little before the next check, returns 1 once the time is up
+int poll_timeout_wait(struct poll_timeout *pt);
+
+/*
+ * Evaluate cond until it's true or timeout_us has passed, 0 if it came
+ * true and -1 on timeout. Spins for the first POLL_SPIN_US, then halts
+ * until the next interrupt between checks if interrupts are on. Once
+ * less than a tick is left it goes back to spinning, so short waits
+ * don't overshoot by a whole tick.
+ */
+#define poll_until(cond, timeout_us)                            \
+    ({                                                          \
+        struct poll_timeout __pt;                               \
+        int __ret;                                              \
+        poll_timeout_start(&__pt, (timeout_us));                \
+        for (;;) {                                              \
+            if (cond) {                                         \
+                __ret = 0;                                      \
+                break;                                          \
+            }                                                   \
+            if (poll_timeout_wait(&__pt)) {                     \
+                __ret = (cond) ? 0 : -1;                        \
+                break;                                          \
+            }                                                   \
+        }                                                       \
+        __ret;                                                  \
+    })
+
+#endif // DELAY_H
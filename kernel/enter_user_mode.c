@@ -9,6 +9,8 @@
  *
  */
 
+#include "sysenter.h"
+
 void __attribute__((section(".userland"))) puts(const char *str) {
     asm volatile (
         "mov %[str], %%ebx;"   // Push the string argument onto the stack
@@ -23,6 +25,8 @@ void __attribute__((section(".userland"))) puts(const char *str) {
 int __attribute__((section(".userland"))) run_user_space() {
    puts("Hello, ring 3 and system calls!");
 
+   sysbench();
+
    for (;;) {
       asm volatile("nop");
    }
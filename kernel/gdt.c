@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include "print.h"
+#include "boottime.h"
 #include "../mm/memory.h"
 
 // GDT entries
@@ -109,40 +110,41 @@ void gdt_set_entry(int num, uint32_t base, uint32_t limit, uint8_t access, uint8
 
 // Function to set up the GDT and load it into the CPU
 void gdt_init() {
-    print("Setting up GDT...\n");
+    boot_print("Setting up GDT...\n");
 
     // Null descriptor (entry 0)
     gdt_set_entry(0, 0, 0, 0, 0);
-    print("Set null descriptor.\n");
+    boot_print("Set null descriptor.\n");
 
     // Kernel code segment (entry 1) - 0x08
     gdt_set_entry(1, 0, 0xFFFFFFFF, 0x9A, 0xCF);
-    print("Set kernel code segment.\n");
+    boot_print("Set kernel code segment.\n");
 
     // Kernel data segment (entry 2) - 0x10
     gdt_set_entry(2, 0, 0xFFFFFFFF, 0x92, 0xCF);
-    print("Set kernel data segment.\n");
+    boot_print("Set kernel data segment.\n");
 
-    // User code segment (entry 3) - 0x18
-    gdt_set_entry(3, 0x0C800000, USER_LIMIT, 0xFA, 0xCF);
-    print("Set user code segment.\n");
+    // User code segment (entry 3) - 0x18, flat like the
+    // segments sysexit loads, so both return paths agree
+    gdt_set_entry(3, 0, USER_LIMIT, 0xFA, 0xCF);
+    boot_print("Set user code segment.\n");
 
     // User data segment (entry 4) - 0x20
-    gdt_set_entry(4, 0x0C800000, USER_LIMIT, 0xF2, 0xCF);
-    print("Set user data segment.\n");
+    gdt_set_entry(4, 0, USER_LIMIT, 0xF2, 0xCF);
+    boot_print("Set user data segment.\n");
 
     // TSS descriptor (entry 5) - 0x28
     kmemset(&tss, 0, sizeof(struct tss_entry));
-    print("Cleared TSS struct with kmemset.\n");
+    boot_print("Cleared TSS struct with kmemset.\n");
     tss_init();
-    print("Successfully initialized TSS.\n");
+    boot_print("Successfully initialized TSS.\n");
     gdt_set_entry(5, (uint32_t)&tss, sizeof(struct tss_entry), 0x89, 0x40); // Access flags for TSS descriptor
-    print("Set TSS descriptor.\n");
+    boot_print("Set TSS descriptor.\n");
 
     // Set up the GDT pointer
     gdtp.limit = (sizeof(gdt) - 1);
     gdtp.base = (uint32_t)&gdt;
-    print("Loading GDT...\n");
+    boot_print("Loading GDT...\n");
 
     // Load the GDT using inline assembly
     asm volatile(
@@ -162,6 +164,6 @@ void gdt_init() {
         : "memory"
     );
     flush_tss();
-    print("Flushed TSS.\n");
-    print("GDT loaded successfully.\n");
+    boot_print("Flushed TSS.\n");
+    boot_print("GDT loaded successfully.\n");
 }
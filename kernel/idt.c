@@ -11,20 +11,34 @@
 #include <stdint.h>
 #include "interrupt.h"
 #include "print.h"
+#include "boottime.h"
 #include "io.h"
 #include "process.h"
 #include "panic.h"
 #include "time.h"
+#include "timer.h"
+#include "profile.h"
+#include "ptrace.h"
+#include "irqstat.h"
+#include "schedstat.h"
+#include "softirq.h"
+#include "rcu.h"
+#include "apic.h"
 
 #define IDT_ENTRIES 256
 
 extern void software_isr_wrapper(void);
 extern void keyboard_isr_wrapper(void);
-extern void pit_isr_wrapper(void);
+extern void mouse_isr_wrapper(void);
+extern void serial_isr_wrapper(void);
+extern void timer_isr_wrapper(void);
+extern void spurious_isr_wrapper(void);
 extern void gpf_isr_wrapper(void);
 extern long saved_cpl;
 
 void gpf_handler() {
+    irqstat_count(0x0D);
+
     if (saved_cpl == 3) {
         terminate_process(current_process);
         return;
@@ -34,6 +48,7 @@ void gpf_handler() {
 }
 
 void df_handler() {
+    irqstat_count(0x08);
     panic("Double Fault!");
 }
 
@@ -57,7 +72,7 @@ struct idt_entry idt[IDT_ENTRIES];
 
 void default_handler(void) {
     asm volatile("pushal");
-    outb(0x20, 0x20);
+    irq_eoi(0);
     asm volatile("popal");
     asm volatile("iret");
 }
@@ -79,36 +94,35 @@ void set_idt_entry_exception(int exception_number, void (*handler)()) {
     idt[exception_number].offset_high = ((uintptr_t)handler >> 16) & 0xFFFF;
 }
 
-void irq_clear_mask(uint8_t IRQline) {
-    uint16_t port;
-    uint8_t value;
+int kunk = 0;
 
-    if(IRQline < 8) {
-        port = 0x21;
-    } else {
-        port = 0xA1;
-        IRQline -= 8;
-    }
-    value = inb(port) & ~(1 << IRQline);
-    outb(port, value);        
-}
+// Scheduling tick, from the local APIC timer or the PIT as a fallback
+void timer_isr(struct pt_regs *regs) {
+    // Before anything else, this is how late the tick is
+    irqstat_timer_latency();
 
-int kunk = 0;
+    irq_enter(0);
 
-void pit_isr() {
-    static uint32_t ticks = 0;
-    ticks++;
+    timekeeping_tick();
 
-    // PIT is set to fire 250 times per second
-    if (ticks >= 250) {
-        unix_time++;
-        ticks = 0;
-    }
+    prof_tick(regs);
+
+    schedstat_tick();
 
     kunk ^= 1;
 
-    schedule();
-    outb(0x20, 0x20);
+    lapic_timer_rearm();
+
+    rcu_check_callbacks();
+
+    raise_softirq_irqoff(TIMER_SOFTIRQ);
+
+    scheduler_tick();
+
+    // Acknowledge before irq_exit(), a context switch there doesn't come back here
+    irq_eoi(0);
+
+    irq_exit(0);
 }
 
 void set_idt_entry_syscall(int interrupt_number, void (*handler)()) {
@@ -122,35 +136,41 @@ void set_idt_entry_syscall(int interrupt_number, void (*handler)()) {
 
 // Function to initialize the IDT
 void init_idt() {
-    print("Preparing IDT...\n");
+    boot_print("Preparing IDT...\n");
 
     // Set specific IDT entries (e.g., software interrupt)
     set_idt_entry_syscall(0x80, software_isr_wrapper); // Software interrupt for syscalls
 
-    print("Set system call handler.\n");
+    boot_print("Set system call handler.\n");
 
     set_idt_entry(0x21, keyboard_isr_wrapper); // Hardware interrupt for keyboards
 
-    print("Set keyboard handler.\n");
+    set_idt_entry(IRQ_BASE_VECTOR + 12, mouse_isr_wrapper); // PS/2 mouse
 
-    set_idt_entry(0x20, pit_isr_wrapper); // Hardware interrupt for PIT
+    set_idt_entry(IRQ_BASE_VECTOR + 4, serial_isr_wrapper); // COM1
 
-    print("Set PIT handler.\n");
+    boot_print("Set keyboard handler.\n");
+
+    set_idt_entry(TIMER_VECTOR, timer_isr_wrapper); // Hardware interrupt for the tick (APIC timer or PIT)
+
+    boot_print("Set timer handler.\n");
+
+    set_idt_entry(SPURIOUS_VECTOR, spurious_isr_wrapper); // Local APIC spurious interrupts
 
     set_idt_entry_exception(0x0D, gpf_handler); // Fault handler for GPF
 
-    print("Set GPF handler.\n");
+    boot_print("Set GPF handler.\n");
 
     set_idt_entry_exception(0x08, df_handler); // Fault handler for DF
 
-    print("Set DF handler.\n");
+    boot_print("Set DF handler.\n");
 
     // Prepare the IDT pointer
     struct idt_pointer idtp;
     idtp.limit = (sizeof(struct idt_entry) * IDT_ENTRIES) - 1; // Size of IDT - 1
     idtp.base = (uint32_t)&idt; // Base address of IDT
 
-    print("Loading IDT...\n");
+    boot_print("Loading IDT...\n");
     
     // Load the IDT using the lidt instruction
     asm volatile("lidt %0" : : "m"(idtp));
@@ -158,28 +178,29 @@ void init_idt() {
     outb(0x20, 0x11);  // ICW1 for master PIC: begin initialization, cascade mode
     outb(0xA0, 0x11);  // ICW1 for slave PIC: same for slave PIC
 
-    print("ICW1 set...\n");
+    boot_print("ICW1 set...\n");
 
     outb(0x21, 0x20);  // ICW2 for master PIC: vector offset 0x20
     outb(0xA1, 0x28);  // ICW2 for slave PIC: vector offset 0x28
 
-    print("ICW2 set...\n");
+    boot_print("ICW2 set...\n");
 
     outb(0x21, 0x04);  // ICW3 for master PIC: tell it the slave is on IRQ2
     outb(0xA1, 0x02);  // ICW3 for slave PIC: tell it the master is on IRQ2
 
-    print("ICW3 set...\n");
+    boot_print("ICW3 set...\n");
  
     outb(0x21, 0x01);  // ICW4 for master PIC: 8086 mode, no special features
     outb(0xA1, 0x01);  // ICW4 for slave PIC: 8086 mode, no special features
 
-    print("ICW4 set...\n");
+    boot_print("ICW4 set...\n");
 
     outb(0x21, 0xFF);  // Mask all IRQs on master PIC
     outb(0xA1, 0xFF);  // Mask all IRQs on slave PIC
-    irq_clear_mask(1); // Unmask IRQ1 (keyboard)
-    irq_clear_mask(0); // Unmask IRQ0 (PIT)
 
-    print("OCW1 set...\n");
+    boot_print("OCW1 set...\n");
+
+    // Lines are unmasked with irq_unmask() once we know whether the
+    // local APIC or the PIC is delivering them
 
 }
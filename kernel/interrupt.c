@@ -10,10 +10,41 @@
 
 #include <stdint.h>
 #include "syscall_dispatcher.h"
+#include "trace.h"
+#include "cputime.h"
+#include "irqstat.h"
+#include "apic.h"
+#include "percpu.h"
+#include "process.h"
+#include "softirq.h"
 
 // Interrupt handler for the software interrupt
-void software_interrupt_handler(int syscall_number, void *arg1, void *arg2, void *arg3, void *arg4) {
-    int result = syscall_handler(syscall_number, arg1, arg2, arg3, arg4);
+int software_interrupt_handler(int syscall_number, void *arg1, void *arg2, void *arg3,
+                               void *arg4, void *arg5, void *arg6) {
+    irqstat_count(0x80);
 
-    asm volatile ("movl %0, %%eax" : : "r"(result));
+    return syscall_handler(syscall_number, arg1, arg2, arg3, arg4, arg5, arg6);
+}
+
+// Bracket every hardware interrupt handler
+void irq_enter(uint32_t irq) {
+    hardirq_count[smp_processor_id()]++;
+    irqstat_enter(IRQ_BASE_VECTOR + irq);
+    cputime_enter(CPUTIME_IRQ);
+    trace_irq_enter(irq);
+}
+
+void irq_exit(uint32_t irq) {
+    trace_irq_exit(irq);
+    cputime_exit();
+    irqstat_exit(IRQ_BASE_VECTOR + irq);
+    hardirq_count[smp_processor_id()]--;
+
+    // Leaving the outermost handler, the device has its EOI by now
+    if (!in_interrupt()) {
+        if (local_softirq_pending()) {
+            do_softirq();
+        }
+        preempt_schedule_irq();
+    }
 }
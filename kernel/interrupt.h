@@ -3,6 +3,12 @@
 #ifndef INTERRUPT_H
 #define INTERRUPT_H
 
-void software_interrupt_handler();
+#include <stdint.h>
+
+int software_interrupt_handler(int syscall_number, void *arg1, void *arg2, void *arg3,
+                               void *arg4, void *arg5, void *arg6);
+
+void irq_enter(uint32_t irq);
+void irq_exit(uint32_t irq);
 
 #endif // INTERRUPT_H
@@ -0,0 +1,42 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef IRQFLAGS_H
+#define IRQFLAGS_H
+
+#include <stdint.h>
+
+#define EFLAGS_IF 0x200  // Interrupt enable flag
+
+static inline uint32_t arch_local_save_flags(void) {
+    uint32_t flags;
+    asm volatile("pushfl\n"
+                 "popl %0\n"
+                 : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline uint32_t arch_local_irq_save(void) {
+    uint32_t flags = arch_local_save_flags();
+    asm volatile("cli" : : : "memory");
+    return flags;
+}
+
+static inline void arch_local_irq_restore(uint32_t flags) {
+    if (flags & EFLAGS_IF)
+        asm volatile("sti" : : : "memory");
+}
+
+// Save EFLAGS into flags and disable interrupts
+#define local_irq_save(flags) do { (flags) = arch_local_irq_save(); } while (0)
+
+// Re-enable interrupts only if they were enabled when flags was saved
+#define local_irq_restore(flags) arch_local_irq_restore(flags)
+
+#define local_irq_disable() asm volatile("cli" : : : "memory")
+#define local_irq_enable()  asm volatile("sti" : : : "memory")
+
+static inline int irqs_disabled(void) {
+    return !(arch_local_save_flags() & EFLAGS_IF);
+}
+
+#endif // IRQFLAGS_H
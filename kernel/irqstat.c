@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/irqstat.c
+ *
+ * Interrupt counts, handler time and timer interrupt latency.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "apic.h"
+#include "irqstat.h"
+#include "log2.h"
+#include "math64.h"
+#include "percpu.h"
+#include "pit.h"
+#include "tsc.h"
+#include "../mm/memory.h"
+
+#define IRQSTAT_MAX_NESTING 4
+
+volatile uint32_t irq_spurious_count = 0;
+
+// All per CPU and only written with interrupts off, no locking needed
+static struct irq_stat irq_stats[NR_CPUS][NR_VECTORS];
+static struct irq_latency timer_latency[NR_CPUS];
+
+static struct {
+    int depth;
+    uint64_t start[IRQSTAT_MAX_NESTING];
+} irq_nesting[NR_CPUS];
+
+void irqstat_enter(uint8_t vector) {
+    int cpu = smp_processor_id();
+    int depth = irq_nesting[cpu].depth++;
+
+    irq_stats[cpu][vector].count++;
+    if (depth < IRQSTAT_MAX_NESTING) {
+        irq_nesting[cpu].start[depth] = rdtsc();
+    }
+}
+
+void irqstat_exit(uint8_t vector) {
+    int cpu = smp_processor_id();
+    int depth = --irq_nesting[cpu].depth;
+    struct irq_stat *stat = &irq_stats[cpu][vector];
+
+    if (depth >= 0 && depth < IRQSTAT_MAX_NESTING) {
+        uint64_t cycles = rdtsc() - irq_nesting[cpu].start[depth];
+
+        stat->cycles += cycles;
+        if (cycles > stat->max_cycles) {
+            stat->max_cycles = cycles;
+        }
+    }
+}
+
+void irqstat_count(uint8_t vector) {
+    irq_stats[smp_processor_id()][vector].count++;
+}
+
+void irqstat_timer_latency(void) {
+    struct irq_latency *lat = &timer_latency[smp_processor_id()];
+    uint64_t cycles;
+
+    if (apic_enabled) {
+        if (lapic_timer_latency(&cycles) != 0) {
+            return;
+        }
+    } else {
+        if (!tsc_khz) {
+            return;
+        }
+        cycles = div_u64((uint64_t)pit_elapsed() * tsc_khz * 1000, PIT_HZ);
+    }
+
+    lat->samples++;
+    lat->total += cycles;
+    if (cycles > lat->max) {
+        lat->max = cycles;
+    }
+    lat->hist[hist_bucket(cycles)]++;
+}
+
+void irqstat_sum(uint8_t vector, struct irq_stat *out) {
+    kmemset(out, 0, sizeof(*out));
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct irq_stat *stat = &irq_stats[cpu][vector];
+
+        out->count += stat->count;
+        out->cycles += stat->cycles;
+        if (stat->max_cycles > out->max_cycles) {
+            out->max_cycles = stat->max_cycles;
+        }
+    }
+
+    if (vector == SPURIOUS_VECTOR) {
+        out->count += irq_spurious_count;
+    }
+}
+
+void irqstat_latency(struct irq_latency *out) {
+    kmemset(out, 0, sizeof(*out));
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct irq_latency *lat = &timer_latency[cpu];
+
+        out->samples += lat->samples;
+        out->total += lat->total;
+        if (lat->max > out->max) {
+            out->max = lat->max;
+        }
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            out->hist[i] += lat->hist[i];
+        }
+    }
+}
+
+void irqstat_reset(void) {
+    kmemset(irq_stats, 0, sizeof(irq_stats));
+    kmemset(timer_latency, 0, sizeof(timer_latency));
+    irq_spurious_count = 0;
+}
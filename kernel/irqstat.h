@@ -0,0 +1,41 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef IRQSTAT_H
+#define IRQSTAT_H
+
+#include <stdint.h>
+#include "log2.h"
+
+#define NR_VECTORS 256
+
+struct irq_stat {
+    uint32_t count;
+    uint64_t cycles;      // Spent in the handler
+    uint64_t max_cycles;
+};
+
+// How late the timer interrupt ran against when it was due
+struct irq_latency {
+    uint32_t samples;
+    uint64_t total;
+    uint64_t max;
+    uint32_t hist[HIST_BUCKETS];
+};
+
+extern volatile uint32_t irq_spurious_count;  // Bumped by spurious_isr_wrapper
+
+// Around a handler, from irq_enter()/irq_exit()
+void irqstat_enter(uint8_t vector);
+void irqstat_exit(uint8_t vector);
+
+// Just count it, for vectors that aren't timed (syscalls, faults)
+void irqstat_count(uint8_t vector);
+
+// Called first thing in the timer interrupt
+void irqstat_timer_latency(void);
+
+void irqstat_sum(uint8_t vector, struct irq_stat *out);
+void irqstat_latency(struct irq_latency *out);
+void irqstat_reset(void);
+
+#endif // IRQSTAT_H
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/jump_label.c
+ *
+ * Patching static key branch sites.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "cpuid.h"
+#include "irqflags.h"
+#include "jump_label.h"
+#include "spinlock.h"
+
+// From linker.ld
+extern struct jump_entry __start___jump_table[], __stop___jump_table[];
+
+static DEFINE_SPINLOCK(jump_label_lock);
+
+static const uint8_t nop5[5] = { 0x0f, 0x1f, 0x44, 0x00, 0x00 };
+
+static void patch_site(struct jump_entry *entry, int enable) {
+    volatile uint8_t *code = (volatile uint8_t *)entry->code;
+
+    if (enable) {
+        uint32_t rel = entry->target - (entry->code + 5);
+
+        // The opcode goes in last, so the site is never half a jmp
+        code[1] = rel & 0xFF;
+        code[2] = (rel >> 8) & 0xFF;
+        code[3] = (rel >> 16) & 0xFF;
+        code[4] = (rel >> 24) & 0xFF;
+        code[0] = 0xE9;
+    } else {
+        code[0] = nop5[0];
+        for (int i = 1; i < 5; i++) {
+            code[i] = nop5[i];
+        }
+    }
+}
+
+/*
+ * No paging yet, so .text is writable as is. Interrupts stay off while
+ * sites are rewritten and cpuid serialises before anything runs them.
+ */
+static void jump_label_update(struct static_key *key, int enable) {
+    uint32_t flags, eax, ebx, ecx, edx;
+
+    spin_lock_irqsave(&jump_label_lock, flags);
+    if (key->enabled != enable) {
+        key->enabled = enable;
+        for (struct jump_entry *entry = __start___jump_table; entry < __stop___jump_table; entry++) {
+            if (entry->key == (uint32_t)key) {
+                patch_site(entry, enable);
+            }
+        }
+        cpuid(0, &eax, &ebx, &ecx, &edx);
+    }
+    spin_unlock_irqrestore(&jump_label_lock, flags);
+}
+
+void static_key_enable(struct static_key *key) {
+    jump_label_update(key, 1);
+}
+
+void static_key_disable(struct static_key *key) {
+    jump_label_update(key, 0);
+}
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef JUMP_LABEL_H
+#define JUMP_LABEL_H
+
+#include <stdint.h>
+
+/*
+ * A static key is a branch that's patched in the code instead of
+ * tested. Every static_branch_unlikely() site starts out as a 5-byte
+ * nop, enabling the key rewrites each of its sites into a jmp to the
+ * unlikely block. Disabled, a site costs one nop.
+ *
+ * Keys have to be globals, the macro names them in the __jump_table
+ * entry it emits (it can't take their address as an "i" operand in
+ * a PIE build).
+ */
+struct static_key {
+    volatile int enabled;
+};
+
+#define STATIC_KEY_INIT { 0 }
+#define DEFINE_STATIC_KEY(name) struct static_key name = STATIC_KEY_INIT
+
+// One per branch site, collected in __jump_table by linker.ld
+struct jump_entry {
+    uint32_t code;    // The 5-byte nop/jmp
+    uint32_t target;  // Where the jmp goes
+    uint32_t key;
+};
+
+#define static_branch_unlikely(key)                                 \
+    ({                                                              \
+        __label__ l_yes, l_out;                                     \
+        int __branch;                                               \
+        asm goto("1: .byte 0x0f, 0x1f, 0x44, 0x00, 0x00\n\t"        \
+                 ".pushsection __jump_table, \"aw\"\n\t"            \
+                 ".balign 4\n\t"                                    \
+                 ".long 1b, %l[l_yes], " #key "\n\t"                \
+                 ".popsection\n\t"                                  \
+                 : : : : l_yes);                                    \
+        __branch = 0;                                               \
+        goto l_out;                                                 \
+    l_yes:                                                          \
+        __branch = 1;                                               \
+    l_out:                                                          \
+        __branch;                                                   \
+    })
+
+void static_key_enable(struct static_key *key);
+void static_key_disable(struct static_key *key);
+
+static inline int static_key_enabled(const struct static_key *key) {
+    return key->enabled;
+}
+
+#endif // JUMP_LABEL_H
@@ -5,8 +5,15 @@
 keyboard_isr_wrapper:
     pushal
     cld              # C code following the sysV ABI requires DF to be clear on function entry
+    pushl $1         # IRQ1
+    call irq_enter
+    addl $4, %esp
     call keyboard_isr
-    movb $0x20, %al
-    outb %al, $0x20
+    pushl $1         # Fresh copy, a callee may have written over its argument
+    call irq_eoi
+    addl $4, %esp
+    pushl $1
+    call irq_exit
+    addl $4, %esp
     popal
     iret
@@ -0,0 +1,123 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef KFIFO_H
+#define KFIFO_H
+
+#include <stdint.h>
+#include "compiler.h"
+
+/*
+ * Single producer, single consumer byte ring. The producer only moves
+ * in and the consumer only moves out, so neither needs a lock, even
+ * when one side is an interrupt handler. Both run freely and wrap; the
+ * size has to be a power of two.
+ */
+struct kfifo {
+    uint8_t *buf;
+    uint32_t mask;          // Size - 1
+    volatile uint32_t in;   // Producer
+    volatile uint32_t out;  // Consumer
+};
+
+#define DEFINE_KFIFO(name, size)                                       \
+    static uint8_t name##_buf[size];                                    \
+    static struct kfifo name = { .buf = name##_buf, .mask = (size) - 1 }
+
+static inline uint32_t kfifo_len(const struct kfifo *fifo) {
+    return READ_ONCE(fifo->in) - READ_ONCE(fifo->out);
+}
+
+static inline uint32_t kfifo_avail(const struct kfifo *fifo) {
+    return fifo->mask + 1 - kfifo_len(fifo);
+}
+
+static inline int kfifo_is_empty(const struct kfifo *fifo) {
+    return kfifo_len(fifo) == 0;
+}
+
+static inline int kfifo_is_full(const struct kfifo *fifo) {
+    return kfifo_len(fifo) > fifo->mask;
+}
+
+// Producer side, returns 0 if there was no room
+static inline int kfifo_put(struct kfifo *fifo, uint8_t c) {
+    uint32_t in = fifo->in;
+
+    if (in - READ_ONCE(fifo->out) > fifo->mask) {
+        return 0;
+    }
+
+    fifo->buf[in & fifo->mask] = c;
+    barrier();  // Data before the index that publishes it
+    WRITE_ONCE(fifo->in, in + 1);
+
+    return 1;
+}
+
+// Consumer side, returns 0 if it was empty
+static inline int kfifo_peek(struct kfifo *fifo, uint8_t *c) {
+    uint32_t out = fifo->out;
+
+    if (out == READ_ONCE(fifo->in)) {
+        return 0;
+    }
+    barrier();
+
+    *c = fifo->buf[out & fifo->mask];
+    return 1;
+}
+
+static inline void kfifo_skip(struct kfifo *fifo) {
+    barrier();  // Done with the slot before handing it back
+    WRITE_ONCE(fifo->out, fifo->out + 1);
+}
+
+static inline int kfifo_get(struct kfifo *fifo, uint8_t *c) {
+    if (!kfifo_peek(fifo, c)) {
+        return 0;
+    }
+
+    kfifo_skip(fifo);
+    return 1;
+}
+
+/*
+ * Fixed size records, all or nothing. Use a record size that divides
+ * the ring size and records never straddle the wrap.
+ */
+static inline int kfifo_in(struct kfifo *fifo, const void *rec, uint32_t len) {
+    uint32_t in = fifo->in;
+    const uint8_t *src = rec;
+
+    if (fifo->mask + 1 - (in - READ_ONCE(fifo->out)) < len) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < len; i++) {
+        fifo->buf[(in + i) & fifo->mask] = src[i];
+    }
+    barrier();
+    WRITE_ONCE(fifo->in, in + len);
+
+    return 1;
+}
+
+static inline int kfifo_out(struct kfifo *fifo, void *rec, uint32_t len) {
+    uint32_t out = fifo->out;
+    uint8_t *dst = rec;
+
+    if (READ_ONCE(fifo->in) - out < len) {
+        return 0;
+    }
+    barrier();
+
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = fifo->buf[(out + i) & fifo->mask];
+    }
+    barrier();
+    WRITE_ONCE(fifo->out, out + len);
+
+    return 1;
+}
+
+#endif // KFIFO_H
@@ -0,0 +1,230 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/kprintf.c
+ *
+ * Formatted output.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "kprintf.h"
+#include "math64.h"
+#include "print.h"
+
+#define FLAG_LEFT  0x01  // '-'
+#define FLAG_ZERO  0x02  // '0'
+
+// Everything is counted, only what fits is stored
+struct kprintf_out {
+    char *buf;
+    size_t size;
+    size_t len;
+};
+
+static void out_char(struct kprintf_out *out, char c) {
+    if (out->len + 1 < out->size) {
+        out->buf[out->len] = c;
+    }
+    out->len++;
+}
+
+static void out_pad(struct kprintf_out *out, char c, int count) {
+    while (count-- > 0) {
+        out_char(out, c);
+    }
+}
+
+static void out_string(struct kprintf_out *out, const char *str, int width, int flags) {
+    int len = 0;
+
+    if (!str) {
+        str = "(null)";
+    }
+    while (str[len]) {
+        len++;
+    }
+
+    if (!(flags & FLAG_LEFT)) {
+        out_pad(out, ' ', width - len);
+    }
+    while (*str) {
+        out_char(out, *str++);
+    }
+    if (flags & FLAG_LEFT) {
+        out_pad(out, ' ', width - len);
+    }
+}
+
+static void out_number(struct kprintf_out *out, uint64_t num, int negative,
+                       uint32_t base, int upper, int width, int flags) {
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[24];
+    int len = 0;
+    uint32_t rem;
+
+    // 32-bit values are the common case, keep them off the 64-bit path
+    do {
+        if (num >> 32) {
+            num = div_u64_rem(num, base, &rem);
+        } else {
+            rem = (uint32_t)num % base;
+            num = (uint32_t)num / base;
+        }
+        tmp[len++] = digits[rem];
+    } while (num);
+
+    width -= len + negative;
+
+    if (flags & FLAG_LEFT) {
+        if (negative) {
+            out_char(out, '-');
+        }
+        while (len) {
+            out_char(out, tmp[--len]);
+        }
+        out_pad(out, ' ', width);
+        return;
+    }
+
+    // Zero padding goes between the sign and the digits
+    if (flags & FLAG_ZERO) {
+        if (negative) {
+            out_char(out, '-');
+        }
+        out_pad(out, '0', width);
+    } else {
+        out_pad(out, ' ', width);
+        if (negative) {
+            out_char(out, '-');
+        }
+    }
+
+    while (len) {
+        out_char(out, tmp[--len]);
+    }
+}
+
+int kvsnprintf(char *buf, size_t size, const char *fmt, va_list args) {
+    struct kprintf_out out = { .buf = buf, .size = size, .len = 0 };
+
+    for (; *fmt; fmt++) {
+        int flags = 0, width = 0, longs = 0;
+        uint64_t num;
+        int64_t snum;
+
+        if (*fmt != '%') {
+            out_char(&out, *fmt);
+            continue;
+        }
+        fmt++;
+
+        for (;; fmt++) {
+            if (*fmt == '-') {
+                flags |= FLAG_LEFT;
+            } else if (*fmt == '0') {
+                flags |= FLAG_ZERO;
+            } else {
+                break;
+            }
+        }
+
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                flags |= FLAG_LEFT;
+                width = -width;
+            }
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+        }
+
+        // long and size_t are 32 bits here, only ll changes anything
+        while (*fmt == 'l' || *fmt == 'z' || *fmt == 'h') {
+            if (*fmt == 'l') {
+                longs++;
+            }
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case 'd':
+            case 'i':
+                snum = longs >= 2 ? va_arg(args, int64_t) : va_arg(args, int32_t);
+                num = snum < 0 ? -(uint64_t)snum : (uint64_t)snum;
+                out_number(&out, num, snum < 0, 10, 0, width, flags);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+                num = longs >= 2 ? va_arg(args, uint64_t) : va_arg(args, uint32_t);
+                out_number(&out, num, 0, *fmt == 'u' ? 10 : 16, *fmt == 'X', width, flags);
+                break;
+            case 'p':
+                out_char(&out, '0');
+                out_char(&out, 'x');
+                out_number(&out, (uintptr_t)va_arg(args, void *), 0, 16, 0, 8, FLAG_ZERO);
+                break;
+            case 's':
+                out_string(&out, va_arg(args, const char *), width, flags);
+                break;
+            case 'c':
+                if (!(flags & FLAG_LEFT)) {
+                    out_pad(&out, ' ', width - 1);
+                }
+                out_char(&out, (char)va_arg(args, int));
+                if (flags & FLAG_LEFT) {
+                    out_pad(&out, ' ', width - 1);
+                }
+                break;
+            case '%':
+                out_char(&out, '%');
+                break;
+            case '\0':
+                fmt--;  // Stray % at the end, let the loop stop
+                break;
+            default:
+                // Unknown conversion, show it rather than guess at the argument
+                out_char(&out, '%');
+                out_char(&out, *fmt);
+                break;
+        }
+    }
+
+    if (size) {
+        buf[out.len < size ? out.len : size - 1] = '\0';
+    }
+
+    return out.len;
+}
+
+int ksnprintf(char *buf, size_t size, const char *fmt, ...) {
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = kvsnprintf(buf, size, fmt, args);
+    va_end(args);
+
+    return len;
+}
+
+int kprintf(const char *fmt, ...) {
+    char buf[KPRINTF_BUF_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = kvsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    print(buf);
+
+    return len;
+}
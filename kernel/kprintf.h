@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef KPRINTF_H
+#define KPRINTF_H
+
+#include <stdarg.h>
+#include <stddef.h>
+
+/*
+ * %d %i %u %x %X %p %s %c and %%, with '-' and '0' flags, a field
+ * width (or '*') and l/ll/z length modifiers. %p prints 0x and eight
+ * hex digits.
+ */
+
+#define KPRINTF_BUF_SIZE 256  // kprintf() output past this is cut off
+
+// Like snprintf(), the return value is the length it wanted, even if cut short
+int kvsnprintf(char *buf, size_t size, const char *fmt, va_list args);
+int ksnprintf(char *buf, size_t size, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+// Formats on the stack, then one print()
+int kprintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // KPRINTF_H
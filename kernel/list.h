@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef LIST_H
+#define LIST_H
+
+#include <stddef.h>
+#include "compiler.h"
+
+// Circular doubly linked list, embedded in whatever it links together
+struct list_head {
+    struct list_head *next, *prev;
+};
+
+#define LIST_HEAD_INIT(name) { &(name), &(name) }
+#define LIST_HEAD(name) struct list_head name = LIST_HEAD_INIT(name)
+
+static inline void INIT_LIST_HEAD(struct list_head *list) {
+    list->next = list;
+    list->prev = list;
+}
+
+static inline void __list_add(struct list_head *new, struct list_head *prev, struct list_head *next) {
+    next->prev = new;
+    new->next = next;
+    new->prev = prev;
+    prev->next = new;
+}
+
+static inline void list_add(struct list_head *new, struct list_head *head) {
+    __list_add(new, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *new, struct list_head *head) {
+    __list_add(new, head->prev, head);
+}
+
+static inline void list_del(struct list_head *entry) {
+    entry->next->prev = entry->prev;
+    entry->prev->next = entry->next;
+    entry->next = NULL;
+    entry->prev = NULL;
+}
+
+static inline void list_del_init(struct list_head *entry) {
+    entry->next->prev = entry->prev;
+    entry->prev->next = entry->next;
+    INIT_LIST_HEAD(entry);
+}
+
+static inline int list_empty(const struct list_head *head) {
+    return head->next == head;
+}
+
+// Move everything on old over to new, leaving old empty
+static inline void list_replace_init(struct list_head *old, struct list_head *new) {
+    if (list_empty(old)) {
+        INIT_LIST_HEAD(new);
+        return;
+    }
+
+    new->next = old->next;
+    new->next->prev = new;
+    new->prev = old->prev;
+    new->prev->next = new;
+    INIT_LIST_HEAD(old);
+}
+
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+
+#define list_first_entry(head, type, member) list_entry((head)->next, type, member)
+
+#define list_for_each_entry(pos, head, member)                              \
+    for (pos = list_entry((head)->next, __typeof__(*pos), member);          \
+         &pos->member != (head);                                            \
+         pos = list_entry(pos->member.next, __typeof__(*pos), member))
+
+#define list_for_each_entry_safe(pos, n, head, member)                      \
+    for (pos = list_entry((head)->next, __typeof__(*pos), member),          \
+         n = list_entry(pos->member.next, __typeof__(*pos), member);        \
+         &pos->member != (head);                                            \
+         pos = n, n = list_entry(n->member.next, __typeof__(*n), member))
+
+#endif // LIST_H
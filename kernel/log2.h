@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef LOG2_H
+#define LOG2_H
+
+#include <stdint.h>
+
+// Floor of log2, 0 for 0. Done in halves, a 64-bit clz would need libgcc.
+static inline int ilog2_u64(uint64_t n) {
+    uint32_t high = (uint32_t)(n >> 32);
+
+    if (high) {
+        return 63 - __builtin_clz(high);
+    }
+    if ((uint32_t)n) {
+        return 31 - __builtin_clz((uint32_t)n);
+    }
+    return 0;
+}
+
+// Histogram bucket for a cycle count: bucket i holds [2^i, 2^(i+1))
+#define HIST_BUCKETS 32
+
+static inline int hist_bucket(uint64_t n) {
+    int bucket = ilog2_u64(n);
+    return bucket < HIST_BUCKETS ? bucket : HIST_BUCKETS - 1;
+}
+
+#endif // LOG2_H
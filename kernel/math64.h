@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef MATH64_H
+#define MATH64_H
+
+#include <stdint.h>
+
+/*
+ * We link without libgcc, so plain 64-bit division on i386 would
+ * pull in __udivdi3. These do it with two 64/32 divl steps instead.
+ */
+
+// Divide a 64-bit value by a 32-bit one, optionally returning the remainder
+static inline __attribute__((always_inline))
+uint64_t div_u64_rem(uint64_t dividend, uint32_t divisor, uint32_t *remainder) {
+    uint32_t high = (uint32_t)(dividend >> 32);
+    uint32_t low = (uint32_t)dividend;
+    uint32_t quot_high = 0;
+    uint32_t quot_low, rem;
+
+    if (high >= divisor) {
+        quot_high = high / divisor;
+        high %= divisor;
+    }
+
+    // high < divisor now, so the quotient fits in 32 bits and divl can't fault
+    asm("divl %4" : "=a"(quot_low), "=d"(rem) : "a"(low), "d"(high), "rm"(divisor));
+
+    if (remainder)
+        *remainder = rem;
+
+    return ((uint64_t)quot_high << 32) | quot_low;
+}
+
+static inline __attribute__((always_inline))
+uint64_t div_u64(uint64_t dividend, uint32_t divisor) {
+    return div_u64_rem(dividend, divisor, 0);
+}
+
+#endif // MATH64_H
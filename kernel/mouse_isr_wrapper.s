@@ -0,0 +1,19 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+.global mouse_isr_wrapper
+
+mouse_isr_wrapper:
+    pushal
+    cld              # C code following the sysV ABI requires DF to be clear on function entry
+    pushl $12        # IRQ12
+    call irq_enter
+    addl $4, %esp
+    call mouse_isr
+    pushl $12
+    call irq_eoi
+    addl $4, %esp
+    pushl $12
+    call irq_exit
+    addl $4, %esp
+    popal
+    iret
@@ -9,8 +9,13 @@
  */
 
 #include "print.h"
+#include "printk.h"
+#include "../drivers/console.h"
 
 void panic(const char *error_message) {
+    // Whatever was logged on the way here, there won't be another softirq
+    log_flush();
+
     // Print error message
     print("\n");
     print("KERNEL HAS ENCOUNTERED SEVERE,\n");
@@ -20,6 +25,7 @@ void panic(const char *error_message) {
     print("\n");
     print("Cause of error: ");
     print(error_message);
+    console_flush();
     // Halt the CPU with an infinite loop
     while (1) {
 	__asm__ volatile ("cli"); // Clear interrupt flag
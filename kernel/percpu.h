@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PERCPU_H
+#define PERCPU_H
+
+#include <stdint.h>
+
+// Only the boot CPU is brought up for now, raise this once APs are
+#define NR_CPUS 1
+
+static inline int smp_processor_id(void) {
+    return 0;
+}
+
+static inline uint32_t cpu_online_mask(void) {
+    return (1U << NR_CPUS) - 1;
+}
+
+#endif // PERCPU_H
@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/pit.c
+ *
+ * 8254 programmable interval timer. Only the fallback tick source
+ * and the reference clock for calibrating the TSC and local APIC.
+ *
+ * Copyright (C) 2024-2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "io.h"
+#include "pit.h"
+
+#define PIT_CH0     0x40
+#define PIT_CH2     0x42
+#define PIT_COMMAND 0x43
+#define PIT_GATE    0x61  // Channel 2 gate (bit 0), speaker (bit 1), OUT2 (bit 5)
+
+static uint16_t pit_divisor;
+
+void setup_pit(uint16_t divisor) {
+    pit_divisor = divisor;
+
+    // Send the control byte to PIT to configure channel 0. Mode 2 counts
+    // straight down once per period, so the count tells how far in we are.
+    outb(PIT_COMMAND, 0x34); // 0x34 is for channel 0, mode 2 (rate generator), binary counting
+
+    // Send the low byte of the divisor
+    outb(PIT_CH0, (uint8_t)(divisor & 0xFF));
+
+    // Send the high byte of the divisor
+    outb(PIT_CH0, (uint8_t)((divisor >> 8) & 0xFF));
+}
+
+void pit_oneshot_start(uint32_t ms) {
+    uint32_t latch = PIT_HZ / 1000 * ms;
+
+    if (latch > 0xFFFF) {
+        latch = 0xFFFF; // About 54 ms is all channel 2 can do
+    }
+
+    // Raise the gate, keep the speaker quiet
+    outb(PIT_GATE, (inb(PIT_GATE) & ~0x02) | 0x01);
+
+    // Channel 2, lobyte/hibyte, mode 0 (interrupt on terminal count)
+    outb(PIT_COMMAND, 0xB0);
+    outb(PIT_CH2, latch & 0xFF);
+    outb(PIT_CH2, (latch >> 8) & 0xFF);
+}
+
+uint32_t pit_elapsed(void) {
+    uint16_t count;
+
+    // Latch channel 0 so the two reads belong together
+    outb(PIT_COMMAND, 0x00);
+    count = inb(PIT_CH0);
+    count |= inb(PIT_CH0) << 8;
+
+    return pit_divisor - count;
+}
+
+int pit_oneshot_expired(void) {
+    return inb(PIT_GATE) & 0x20;
+}
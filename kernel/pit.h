@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PIT_H
+#define PIT_H
+
+#include <stdint.h>
+
+#define PIT_HZ 1193182  // Input clock of the 8254
+
+// Program channel 0 as the periodic tick source
+void setup_pit(uint16_t divisor);
+
+// PIT clocks since channel 0 last fired
+uint32_t pit_elapsed(void);
+
+// Calibration window for the TSC and APIC timer
+#define CALIBRATE_MS 10
+#define CALIBRATE_MAX_LOOPS 10000000  // Give up if channel 2 never fires
+
+// Run channel 2 as a one-shot for the given number of milliseconds
+void pit_oneshot_start(uint32_t ms);
+int pit_oneshot_expired(void);
+
+#endif // PIT_H
@@ -4,5 +4,6 @@
 #define PRINT_H
 
 void print(const char *str);
+void print_char(char c);
 
 #endif // PRINT_H
@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/printk.c
+ *
+ * Kernel log ring and its sinks.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kprintf.h"
+#include "math64.h"
+#include "percpu.h"
+#include "print.h"
+#include "printk.h"
+#include "softirq.h"
+#include "tsc.h"
+#include "boottime.h"
+#include "../drivers/serial.h"
+#include "../mm/memory.h"
+
+int console_loglevel = LOG_WARNING;
+static int serial_loglevel = LOG_DEBUG;
+
+/*
+ * Writers claim a sequence number with a locked add and own that slot
+ * until they publish seq + 1 in it, so nobody waits on anybody. Once
+ * the ring wraps the oldest records get overwritten, readers notice
+ * from the sequence number and skip ahead.
+ */
+static volatile uint32_t log_head;  // Sequence numbers ever claimed
+static struct log_record log_ring[LOG_RING_SIZE];
+static uint64_t log_base_tsc;       // Timestamps count from here
+
+static struct log_sink log_sinks[] = {
+    { .name = "console", .write = print,              .level = &console_loglevel },
+    { .name = "serial",  .write = write_serial_string, .level = &serial_loglevel },
+};
+
+#define NR_LOG_SINKS (sizeof(log_sinks) / sizeof(log_sinks[0]))
+
+void log_store(int level, const char *text, uint32_t len) {
+    uint32_t seq = __atomic_fetch_add(&log_head, 1, __ATOMIC_RELAXED);
+    struct log_record *rec = &log_ring[seq & (LOG_RING_SIZE - 1)];
+
+    if (len > LOG_LINE_MAX) {
+        len = LOG_LINE_MAX;
+    }
+
+    // Readers must not take the last lap's contents for ours
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    rec->level = level;
+    rec->cpu = smp_processor_id();
+    rec->len = len;
+    rec->tsc = rdtsc();
+    kmemcpy(rec->text, text, len);
+
+    __atomic_store_n(&rec->seq, seq + 1, __ATOMIC_RELEASE);
+
+    raise_softirq(LOG_SOFTIRQ);
+}
+
+// One record per line, the newlines themselves aren't kept
+void log_puts(int level, const char *str) {
+    const char *start = str;
+
+    for (; *str; str++) {
+        if (*str == '\n') {
+            log_store(level, start, str - start);
+            start = str + 1;
+        }
+    }
+
+    if (str != start) {
+        log_store(level, start, str - start);
+    }
+}
+
+int printk(int level, const char *fmt, ...) {
+    char buf[KPRINTF_BUF_SIZE];
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = kvsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    log_puts(level, buf);
+
+    return len;
+}
+
+uint32_t log_first_seq(void) {
+    uint32_t head = log_head;
+
+    return head > LOG_RING_SIZE ? head - LOG_RING_SIZE : 0;
+}
+
+int log_read(uint32_t *seq, struct log_record *rec) {
+    for (;;) {
+        uint32_t head = __atomic_load_n(&log_head, __ATOMIC_ACQUIRE);
+        struct log_record *slot = &log_ring[*seq & (LOG_RING_SIZE - 1)];
+        uint32_t published;
+
+        if (*seq == head) {
+            return 0;
+        }
+
+        // Lapped, jump to the oldest record still there
+        if (head - *seq > LOG_RING_SIZE) {
+            *seq = head - LOG_RING_SIZE;
+            continue;
+        }
+
+        published = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (published != *seq + 1) {
+            // Still being written, or already reused and the head check will catch it
+            if (published == 0 || (int32_t)(published - (*seq + 1)) < 0) {
+                return 0;
+            }
+            continue;
+        }
+
+        kmemcpy(rec, slot, sizeof(*rec));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        // A writer lapped us half way through the copy
+        if (slot->seq != published) {
+            continue;
+        }
+
+        *seq += 1;
+        return 1;
+    }
+}
+
+// "[    1.234567] text\n", cut short to fit size but always newline terminated
+uint32_t log_format(const struct log_record *rec, char *buf, uint32_t size) {
+    uint64_t us = 0;
+    uint32_t usec, secs;
+    char *p = buf;
+    int len;
+
+    if (size < 2) {
+        if (size) {
+            *buf = '\0';
+        }
+        return 0;
+    }
+
+    // Converted now, the TSC may not have been calibrated when the record was made
+    if (tsc_khz && rec->tsc > log_base_tsc) {
+        us = div_u64((rec->tsc - log_base_tsc) * 1000, tsc_khz);
+    }
+
+    secs = div_u64_rem(us, 1000000, &usec);
+
+    // Keep a byte back for the newline, and only step over what was stored
+    len = ksnprintf(p, size - 1, "[%5u.%06u] ", secs, usec);
+    p += (uint32_t)len < size - 2 ? (uint32_t)len : size - 2;
+
+    for (uint32_t i = 0; i < rec->len && p < buf + size - 2; i++) {
+        *p++ = rec->text[i];
+    }
+    *p++ = '\n';
+    *p = '\0';
+
+    return p - buf;
+}
+
+static void log_drain(void) {
+    struct log_record rec;
+    char line[LOG_LINE_MAX + 24];
+
+    for (uint32_t i = 0; i < NR_LOG_SINKS; i++) {
+        struct log_sink *sink = &log_sinks[i];
+        uint32_t want = sink->next;
+
+        while (log_read(&sink->next, &rec)) {
+            sink->lost += rec.seq - 1 - want;
+            want = sink->next;
+
+            if (rec.level <= *sink->level) {
+                log_format(&rec, line, sizeof(line));
+                sink->write(line);
+            }
+        }
+    }
+}
+
+void log_flush(void) {
+    log_drain();
+}
+
+void log_init(void) {
+    log_base_tsc = boot_start_tsc();
+    if (!quiet_boot) {
+        console_loglevel = LOG_DEBUG;
+    }
+
+    open_softirq(LOG_SOFTIRQ, log_drain);
+}
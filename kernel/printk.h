@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PRINTK_H
+#define PRINTK_H
+
+#include <stdint.h>
+
+// Same numbering as syslog, lower is more urgent
+#define LOG_EMERG   0
+#define LOG_ALERT   1
+#define LOG_CRIT    2
+#define LOG_ERR     3
+#define LOG_WARNING 4
+#define LOG_NOTICE  5
+#define LOG_INFO    6
+#define LOG_DEBUG   7
+
+#define LOG_RING_SIZE 256  // Records, a power of two
+#define LOG_LINE_MAX  112  // Longer messages are cut short
+
+struct log_record {
+    volatile uint32_t seq;  // Sequence number + 1 once written, 0 while being written
+    uint8_t level;
+    uint8_t cpu;
+    uint16_t len;
+    uint64_t tsc;
+    char text[LOG_LINE_MAX];  // Not terminated, see len
+};
+
+/*
+ * Somewhere for records to go. Sinks are fed from LOG_SOFTIRQ, never
+ * from the caller of log_store(), and each keeps its own place in the
+ * ring so a slow one doesn't hold the others back.
+ */
+struct log_sink {
+    const char *name;
+    void (*write)(const char *line);
+    int *level;      // Records above this level are skipped
+    uint32_t next;   // Next sequence number to hand over
+    uint32_t lost;   // Overwritten before the sink got to them
+};
+
+extern int console_loglevel;
+
+void log_init(void);
+
+// Safe from any context, costs a copy into the ring
+void log_store(int level, const char *text, uint32_t len);
+void log_puts(int level, const char *str);
+int printk(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+// For readers, returns 0 once *seq has caught up with the newest record
+int log_read(uint32_t *seq, struct log_record *rec);
+uint32_t log_first_seq(void);
+uint32_t log_format(const struct log_record *rec, char *buf, uint32_t size);
+
+// Drain the sinks right now, for when interrupts won't come back
+void log_flush(void);
+
+#endif // PRINTK_H
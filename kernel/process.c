@@ -11,13 +11,29 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "../mm/memory.h"
+#include "percpu.h"
 #include "process.h"
 #include "../security/aslr.h"
+#include "spinlock.h"
+#include "rcu.h"
+#include "trace.h"
+#include "cputime.h"
+#include "schedstat.h"
+#include "uring.h"
 
 static uint32_t next_pid = 1;  // Static counter for PID generation
 
 pcb_t *current_process = NULL;
 pcb_t *process_queue = NULL;
+volatile uint32_t nr_running = 0;
+static volatile uint32_t need_resched[NR_CPUS];
+
+/*
+ * The scheduler walks the process list on every tick, so it reads it
+ * under RCU. Only creating or terminating a process takes process_lock,
+ * and terminated PCBs are freed after a grace period.
+ */
+DEFINE_SPINLOCK(process_lock);
 
 void context_switch(pcb_t *next_process) {
     // Save the current process's state
@@ -43,18 +59,95 @@ void context_switch(pcb_t *next_process) {
     );
 }
 
-void schedule() {
-    if (process_queue == NULL) {
+static void __schedule(int preempt) {
+    need_resched[smp_processor_id()] = 0;
+
+    rcu_note_context_switch();
+
+    // Never switch away from an RCU reader, grace periods rely on it
+    if (rcu_read_lock_held()) {
+        return;
+    }
+
+    rcu_read_lock();
+    pcb_t *head = rcu_dereference(process_queue);
+    if (head == NULL) {
+        rcu_read_unlock();
         return; // No processes to schedule
     }
 
-    // Move to the next process in the queue
-    current_process = current_process->next;
+    pcb_t *prev = current_process;
+
+    // Move to the next runnable process in the queue
+    pcb_t *next = prev ? rcu_dereference(prev->next) : head;
+    pcb_t *start = next;
+    while (next->state != PROCESS_RUNNING) {
+        next = rcu_dereference(next->next);
+        if (next == start) {
+            rcu_read_unlock();
+            return; // Nothing runnable
+        }
+    }
+    current_process = next;
+    rcu_read_unlock();
+
+    if (prev != current_process) {
+        cputime_switch(prev, preempt);
+
+        // If it's still runnable it starts waiting for the CPU again now
+        if (prev && prev->state == PROCESS_RUNNING) {
+            schedstat_enqueue(prev, preempt ? SCHED_WAKE_PREEMPT : SCHED_WAKE_YIELD);
+        }
+        schedstat_run(current_process);
+    }
+
+    trace_sched_switch(prev ? prev->pid : 0, current_process->pid);
 
     // Perform context switch to the next process
     context_switch(current_process);
 }
 
+void schedule() {
+    __schedule(0);
+}
+
+void process_wait(pcb_t *pcb) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&process_lock, flags);
+    if (pcb->state == PROCESS_RUNNING) {
+        pcb->state = PROCESS_WAITING;
+        nr_running--;
+    }
+    spin_unlock_irqrestore(&process_lock, flags);
+}
+
+void wake_up_process(pcb_t *pcb) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&process_lock, flags);
+    if (pcb->state == PROCESS_WAITING) {
+        pcb->state = PROCESS_RUNNING;
+        nr_running++;
+        schedstat_enqueue(pcb, SCHED_WAKE_WAKEUP);
+    }
+    spin_unlock_irqrestore(&process_lock, flags);
+}
+
+void preempt_schedule() {
+    __schedule(1);
+}
+
+void scheduler_tick() {
+    need_resched[smp_processor_id()] = 1;
+}
+
+void preempt_schedule_irq() {
+    if (need_resched[smp_processor_id()]) {
+        preempt_schedule();
+    }
+}
+
 int generate_pid() {
     return next_pid++;
 }
@@ -86,6 +179,7 @@ uint32_t* setup_stack() {
 }
 
 pcb_t* create_process(void (*entry_point)()) {
+    uint32_t flags;
     pcb_t *new_pcb = (pcb_t*)kmalloc(sizeof(pcb_t));
     if (new_pcb == NULL) {
         return NULL; // Allocation failed
@@ -109,27 +203,49 @@ pcb_t* create_process(void (*entry_point)()) {
     }
 
     new_pcb->state = PROCESS_RUNNING;
+    kmemset(&new_pcb->cputime, 0, sizeof(new_pcb->cputime));
+    new_pcb->enqueue_tsc = 0;
+    schedstat_enqueue(new_pcb, SCHED_WAKE_NEW);
     new_pcb->eip = (uint32_t)entry_point;
     new_pcb->next = NULL;
 
     // Add to the process queue
+    spin_lock_irqsave(&process_lock, flags);
     if (process_queue == NULL) {
-        process_queue = new_pcb;
         new_pcb->next = new_pcb; // Circular queue for round-robin
+        rcu_assign_pointer(process_queue, new_pcb);
     } else {
         pcb_t *temp = process_queue;
         while (temp->next != process_queue) {
             temp = temp->next;
         }
-        temp->next = new_pcb;
         new_pcb->next = process_queue;
+        rcu_assign_pointer(temp->next, new_pcb);
     }
+    nr_running++;
+    spin_unlock_irqrestore(&process_lock, flags);
 
     return new_pcb;
 }
 
+static void free_process_rcu(struct rcu_head *head) {
+    pcb_t *pcb = container_of(head, pcb_t, rcu);
+
+    kfree(pcb->page_directory);
+    kfree(pcb->stack);
+    kfree(pcb);
+}
+
 void terminate_process(pcb_t *pcb) {
+    uint32_t flags;
+
+    if (pcb) {
+        uring_release(pcb->pid);
+    }
+
+    spin_lock_irqsave(&process_lock, flags);
     if (process_queue == NULL || pcb == NULL) {
+        spin_unlock_irqrestore(&process_lock, flags);
         return;
     }
 
@@ -145,22 +261,27 @@ void terminate_process(pcb_t *pcb) {
                     last = last->next;
                 }
                 if (current->next == current) {
-                    process_queue = NULL;
+                    rcu_assign_pointer(process_queue, NULL);
                 } else {
-                    process_queue = current->next;
-                    last->next = process_queue;
+                    rcu_assign_pointer(process_queue, current->next);
+                    rcu_assign_pointer(last->next, current->next);
                 }
             } else {
-                prev->next = current->next;
+                rcu_assign_pointer(prev->next, current->next);
+            }
+
+            // Readers may still be looking at it, free once they're done
+            if (current->state == PROCESS_RUNNING) {
+                nr_running--;
             }
-            kfree(current->page_directory);
-            kfree(current->stack);
-            kfree(current);
+            current->state = PROCESS_TERMINATED;
+            call_rcu(&current->rcu, free_process_rcu);
             break;
         }
         prev = current;
         current = current->next;
     } while (current != process_queue);
+    spin_unlock_irqrestore(&process_lock, flags);
 }
 
 void initialize_process_system() {
@@ -172,6 +293,10 @@ void sys_yield() {
     schedule(); // Call the scheduler to switch to the next process
 }
 
+int sys_getpid() {
+    return current_process ? current_process->pid : 0;
+}
+
 void sys_exit() {
     // Check if current_process is valid
     if (current_process == NULL) {
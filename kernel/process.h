@@ -4,6 +4,10 @@
 #define PROCESS_H
 
 #include <stdint.h>
+#include "spinlock.h"
+#include "rcu.h"
+#include "cputime.h"
+#include "schedstat.h"
 
 // Process States
 #define PROCESS_RUNNING 0
@@ -20,16 +24,27 @@ typedef struct process_control_block {
     uint32_t esp, ebp;           // Stack pointers (saved during context switch)
     uint32_t eip;                // Instruction pointer (next instruction to execute)
     struct process_control_block *next; // Pointer to the next PCB in the scheduler queue
+    struct rcu_head rcu;         // Deferred free after termination
+    struct task_cputime cputime; // CPU time used and context switches
+    uint64_t enqueue_tsc;        // When it last became runnable, 0 once running
+    uint32_t wake_class;         // How it became runnable, SCHED_WAKE_*
 } pcb_t;
 
 // Global variables (to be defined in the process.c file)
 extern pcb_t *current_process;    // Pointer to the currently running process
 extern pcb_t *process_queue;      // Head of the process queue
+extern spinlock_t process_lock;   // Protects process_queue
+extern volatile uint32_t nr_running;  // Processes in PROCESS_RUNNING
 
 // Function Prototypes
 pcb_t* create_process(void (*entry_point)());
 void terminate_process(pcb_t *pcb);
 void schedule();
+void preempt_schedule();          // Counts as involuntary
+void scheduler_tick();            // Time slice is up, switch on the way out of the interrupt
+void preempt_schedule_irq();      // From irq_exit(), switches if the tick asked to
+void process_wait(pcb_t *pcb);    // Take it off the CPU until woken
+void wake_up_process(pcb_t *pcb);
 void context_switch(pcb_t *next_process);
 int generate_pid();
 uint32_t* setup_page_directory();
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/profile.c
+ *
+ * Sampling profiler, driven by the timer interrupt.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kprintf.h"
+#include "percpu.h"
+#include "profile.h"
+#include "ptrace.h"
+#include "time.h"
+#include "tsc.h"
+#include "../drivers/serial.h"
+
+// From linker.ld
+extern char _stext[], _etext[];
+
+struct prof_buffer {
+    uint32_t nr;       // Samples taken
+    uint32_t dropped;  // Samples lost to a full buffer
+    struct prof_sample samples[PROF_SAMPLES];
+};
+
+static struct prof_buffer prof_buffers[NR_CPUS];
+
+volatile int prof_running = 0;
+static int prof_callchain;
+static uint32_t prof_interval;  // Ticks between samples
+static uint32_t prof_countdown[NR_CPUS];
+
+static int kernel_text(uint32_t addr) {
+    return addr >= (uint32_t)_stext && addr < (uint32_t)_etext;
+}
+
+int prof_start(uint32_t hz, int callchain) {
+    if (hz == 0 || hz > HZ) {
+        return -1;
+    }
+
+    prof_running = 0;
+    prof_interval = HZ / hz;
+    prof_callchain = callchain;
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        prof_countdown[cpu] = prof_interval;
+    }
+    prof_running = 1;
+
+    return 0;
+}
+
+void prof_stop(void) {
+    prof_running = 0;
+}
+
+void prof_reset(void) {
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        prof_buffers[cpu].nr = 0;
+        prof_buffers[cpu].dropped = 0;
+    }
+}
+
+/*
+ * Everything is built with frame pointers, so each frame starts with
+ * the caller's ebp followed by the return address. Stop at anything
+ * that doesn't look like a frame further up the same stack.
+ */
+static uint16_t prof_walk(uint32_t ebp, uint32_t *chain) {
+    uint16_t depth = 0;
+
+    while (depth < PROF_MAX_DEPTH && ebp && !(ebp & 3)) {
+        uint32_t *frame = (uint32_t *)ebp;
+        uint32_t next = frame[0];
+        uint32_t ret = frame[1];
+
+        if (!kernel_text(ret)) {
+            break;
+        }
+        chain[depth++] = ret;
+
+        if (next <= ebp || next - ebp > 0x10000) {
+            break;
+        }
+        ebp = next;
+    }
+
+    return depth;
+}
+
+void prof_tick(struct pt_regs *regs) {
+    int cpu = smp_processor_id();
+    struct prof_buffer *buf = &prof_buffers[cpu];
+
+    if (!prof_running || --prof_countdown[cpu]) {
+        return;
+    }
+    prof_countdown[cpu] = prof_interval;
+
+    if (buf->nr >= PROF_SAMPLES) {
+        buf->dropped++;
+        return;
+    }
+
+    struct prof_sample *sample = &buf->samples[buf->nr];
+    sample->eip = regs->eip;
+    sample->user = user_mode(regs);
+    sample->depth = 0;
+    if (prof_callchain && !sample->user) {
+        sample->depth = prof_walk(regs->ebp, sample->callchain);
+    }
+    buf->nr++;
+}
+
+uint32_t prof_nr_samples(void) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        total += prof_buffers[cpu].nr;
+    }
+
+    return total;
+}
+
+uint32_t prof_nr_dropped(void) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        total += prof_buffers[cpu].dropped;
+    }
+
+    return total;
+}
+
+uint32_t prof_rate(void) {
+    return prof_interval ? HZ / prof_interval : 0;
+}
+
+/*
+ * One line per sample, addresses in hex, innermost first:
+ *   S <cpu> <u|k> <eip> <return address>...
+ * framed by a header and an end marker so the script can pick it out
+ * of whatever else went over the port.
+ */
+void prof_dump_serial(void) {
+    char line[48];  // Longest is the samples and dropped counts, 40 with the newline
+
+    ksnprintf(line, sizeof(line), "# goldspace-prof 1 hz %u", prof_rate());
+    write_serial_string(line);
+    ksnprintf(line, sizeof(line), " samples %u dropped %u\n", prof_nr_samples(), prof_nr_dropped());
+    write_serial_string(line);
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct prof_buffer *buf = &prof_buffers[cpu];
+
+        for (uint32_t i = 0; i < buf->nr; i++) {
+            struct prof_sample *sample = &buf->samples[i];
+
+            ksnprintf(line, sizeof(line), "S %d %c %x", cpu, sample->user ? 'u' : 'k', sample->eip);
+            write_serial_string(line);
+            for (int d = 0; d < sample->depth; d++) {
+                ksnprintf(line, sizeof(line), " %x", sample->callchain[d]);
+                write_serial_string(line);
+            }
+            write_serial_string("\n");
+        }
+    }
+
+    write_serial_string("# end\n");
+}
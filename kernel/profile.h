@@ -0,0 +1,36 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include "ptrace.h"
+
+#define PROF_SAMPLES   4096  // Per CPU
+#define PROF_MAX_DEPTH 8     // Return addresses kept per sample
+
+struct prof_sample {
+    uint32_t eip;
+    uint16_t depth;          // Entries used in callchain
+    uint16_t user;           // Interrupted in ring 3, no callchain
+    uint32_t callchain[PROF_MAX_DEPTH];
+};
+
+extern volatile int prof_running;
+
+// Start sampling at about hz per second, walking frame pointers if callchain
+int prof_start(uint32_t hz, int callchain);
+void prof_stop(void);
+void prof_reset(void);
+
+// Called from the timer interrupt with the interrupted registers
+void prof_tick(struct pt_regs *regs);
+
+uint32_t prof_nr_samples(void);
+uint32_t prof_nr_dropped(void);
+uint32_t prof_rate(void);
+
+// Write every sample out on COM1 for scripts/profile.py
+void prof_dump_serial(void);
+
+#endif // PROFILE_H
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef PTRACE_H
+#define PTRACE_H
+
+#include <stdint.h>
+
+// Registers as an interrupt wrapper leaves them: pushal, then the CPU's frame
+struct pt_regs {
+    uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax;  // pushal
+    uint32_t eip, cs, eflags;                         // Pushed by the CPU
+};
+
+static inline int user_mode(const struct pt_regs *regs) {
+    return (regs->cs & 3) != 0;
+}
+
+#endif // PTRACE_H
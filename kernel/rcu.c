@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/rcu.c
+ *
+ * Read-copy-update grace period tracking and deferred frees.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "rcu.h"
+#include "softirq.h"
+#include "spinlock.h"
+#include "tsc.h"
+
+volatile uint32_t rcu_read_nesting[NR_CPUS];
+
+static DEFINE_SPINLOCK(rcu_lock);  // Protects everything below
+
+static uint32_t rcu_gp_seq = 0;           // Completed grace periods
+static uint32_t rcu_gp_active = 0;        // Is a grace period running?
+static uint32_t rcu_qs_pending = 0;       // CPUs that still owe a quiescent state
+
+// Callbacks queued since the current grace period started
+static struct rcu_head *rcu_next_list = NULL;
+static struct rcu_head **rcu_next_tail = &rcu_next_list;
+
+// Callbacks waiting for the current grace period
+static struct rcu_head *rcu_wait_list = NULL;
+
+// Callbacks whose grace period is over, ready to run
+static struct rcu_head *rcu_done_list = NULL;
+static struct rcu_head **rcu_done_tail = &rcu_done_list;
+
+// Called with rcu_lock held
+static void rcu_start_gp(void) {
+    if (rcu_gp_active || !rcu_next_list)
+        return;
+
+    rcu_wait_list = rcu_next_list;
+    rcu_next_list = NULL;
+    rcu_next_tail = &rcu_next_list;
+
+    rcu_qs_pending = cpu_online_mask();
+    rcu_gp_active = 1;
+}
+
+// Called with rcu_lock held
+static void rcu_report_qs(int cpu) {
+    if (!rcu_gp_active)
+        return;
+
+    rcu_qs_pending &= ~(1U << cpu);
+    if (rcu_qs_pending)
+        return;
+
+    // Everyone has been through a quiescent state, the grace period is over
+    *rcu_done_tail = rcu_wait_list;
+    while (*rcu_done_tail)
+        rcu_done_tail = &(*rcu_done_tail)->next;
+    rcu_wait_list = NULL;
+
+    rcu_gp_active = 0;
+    rcu_gp_seq++;
+
+    rcu_start_gp();
+}
+
+static void rcu_invoke_callbacks(void) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&rcu_lock, flags);
+    struct rcu_head *list = rcu_done_list;
+    rcu_done_list = NULL;
+    rcu_done_tail = &rcu_done_list;
+    spin_unlock_irqrestore(&rcu_lock, flags);
+
+    while (list) {
+        struct rcu_head *next = list->next;
+        list->func(list);
+        list = next;
+    }
+}
+
+void call_rcu(struct rcu_head *head, void (*func)(struct rcu_head *head)) {
+    uint32_t flags;
+
+    head->func = func;
+    head->next = NULL;
+
+    spin_lock_irqsave(&rcu_lock, flags);
+    *rcu_next_tail = head;
+    rcu_next_tail = &head->next;
+    rcu_start_gp();
+    spin_unlock_irqrestore(&rcu_lock, flags);
+}
+
+void rcu_note_context_switch(void) {
+    uint32_t flags;
+    int cpu = smp_processor_id();
+
+    if (rcu_read_nesting[cpu])
+        return; // Still inside a read-side section, not quiescent
+
+    spin_lock_irqsave(&rcu_lock, flags);
+    rcu_report_qs(cpu);
+    spin_unlock_irqrestore(&rcu_lock, flags);
+}
+
+// From the tick, the callbacks themselves run in RCU_SOFTIRQ
+void rcu_check_callbacks(void) {
+    if (rcu_done_list)
+        raise_softirq_irqoff(RCU_SOFTIRQ);
+}
+
+void rcu_init(void) {
+    open_softirq(RCU_SOFTIRQ, rcu_invoke_callbacks);
+}
+
+struct rcu_synchronize {
+    struct rcu_head head;
+    volatile int done;
+};
+
+static void wakeme_after_rcu(struct rcu_head *head) {
+    ((struct rcu_synchronize *)head)->done = 1;
+}
+
+void synchronize_rcu(void) {
+    struct rcu_synchronize rs;
+
+    rs.done = 0;
+    call_rcu(&rs.head, wakeme_after_rcu);
+
+    /*
+     * We are not in a read-side section ourselves, so this CPU can
+     * report its own quiescent state instead of waiting for a tick.
+     * Other CPUs report theirs from schedule().
+     */
+    while (!rs.done) {
+        rcu_note_context_switch();
+        rcu_invoke_callbacks();
+        if (!rs.done)
+            cpu_relax();
+    }
+}
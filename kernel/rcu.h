@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef RCU_H
+#define RCU_H
+
+#include <stdint.h>
+#include "compiler.h"
+#include "percpu.h"
+
+/*
+ * Read-copy-update for read-mostly tables.
+ *
+ * Readers only bump a per-CPU nesting count, no atomics and no shared
+ * cache lines. A reader must not block or switch tasks, schedule()
+ * refuses to switch away while one is running. A CPU that goes through
+ * schedule() outside a read-side section has passed a quiescent state,
+ * and once every CPU has done so the grace period is over and memory
+ * unlinked before it started can be freed.
+ */
+
+struct rcu_head {
+    struct rcu_head *next;
+    void (*func)(struct rcu_head *head);
+};
+
+extern volatile uint32_t rcu_read_nesting[NR_CPUS];
+
+static inline void rcu_read_lock(void) {
+    rcu_read_nesting[smp_processor_id()]++;
+    barrier();
+}
+
+static inline void rcu_read_unlock(void) {
+    barrier();
+    rcu_read_nesting[smp_processor_id()]--;
+}
+
+static inline int rcu_read_lock_held(void) {
+    return rcu_read_nesting[smp_processor_id()] != 0;
+}
+
+// Fetch an RCU-protected pointer inside a read-side section
+#define rcu_dereference(p) __atomic_load_n(&(p), __ATOMIC_CONSUME)
+
+// Publish a fully initialised object to readers
+#define rcu_assign_pointer(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+
+// Run func(head) once every current reader has finished
+void call_rcu(struct rcu_head *head, void (*func)(struct rcu_head *head));
+
+// Wait for a full grace period
+void synchronize_rcu(void);
+
+// Scheduler hook, this CPU is passing a quiescent state
+void rcu_note_context_switch(void);
+
+// Timer tick hook, queues finished callbacks for RCU_SOFTIRQ
+void rcu_check_callbacks(void);
+
+void rcu_init(void);
+
+#endif // RCU_H
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/schedstat.c
+ *
+ * Scheduling latency and run queue length statistics.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "log2.h"
+#include "percpu.h"
+#include "process.h"
+#include "schedstat.h"
+#include "tsc.h"
+#include "../mm/memory.h"
+
+static const char *wake_class_names[SCHED_NR_WAKE] = {
+    [SCHED_WAKE_NEW]     = "new",
+    [SCHED_WAKE_WAKEUP]  = "wakeup",
+    [SCHED_WAKE_PREEMPT] = "preempted",
+    [SCHED_WAKE_YIELD]   = "yield",
+};
+
+static struct sched_latency sched_latencies[NR_CPUS][SCHED_NR_WAKE];
+
+static uint16_t rq_history[RQ_SAMPLES];
+static uint32_t rq_samples;  // Ever taken, the ring holds the last RQ_SAMPLES
+static uint32_t rq_max;
+static uint32_t rq_countdown = RQ_SAMPLE_TICKS;
+
+void schedstat_enqueue(pcb_t *pcb, int wake_class) {
+    if (!pcb) {
+        return;
+    }
+
+    pcb->enqueue_tsc = rdtsc();
+    pcb->wake_class = wake_class;
+}
+
+void schedstat_run(pcb_t *pcb) {
+    struct sched_latency *lat;
+    uint64_t delay;
+
+    if (!pcb || !pcb->enqueue_tsc) {
+        return;
+    }
+
+    delay = rdtsc() - pcb->enqueue_tsc;
+    pcb->enqueue_tsc = 0;
+
+    lat = &sched_latencies[smp_processor_id()][pcb->wake_class];
+    lat->count++;
+    lat->total += delay;
+    if (delay > lat->max) {
+        lat->max = delay;
+    }
+    lat->hist[hist_bucket(delay)]++;
+}
+
+void schedstat_tick(void) {
+    uint32_t running;
+
+    if (--rq_countdown) {
+        return;
+    }
+    rq_countdown = RQ_SAMPLE_TICKS;
+
+    running = nr_running;
+    rq_history[rq_samples % RQ_SAMPLES] = running > 0xFFFF ? 0xFFFF : running;
+    rq_samples++;
+    if (running > rq_max) {
+        rq_max = running;
+    }
+}
+
+void schedstat_latency(int wake_class, struct sched_latency *out) {
+    kmemset(out, 0, sizeof(*out));
+
+    if (wake_class < 0 || wake_class >= SCHED_NR_WAKE) {
+        return;
+    }
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct sched_latency *lat = &sched_latencies[cpu][wake_class];
+
+        out->count += lat->count;
+        out->total += lat->total;
+        if (lat->max > out->max) {
+            out->max = lat->max;
+        }
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            out->hist[i] += lat->hist[i];
+        }
+    }
+}
+
+const char *schedstat_class_name(int wake_class) {
+    if (wake_class < 0 || wake_class >= SCHED_NR_WAKE) {
+        return "unknown";
+    }
+
+    return wake_class_names[wake_class];
+}
+
+int schedstat_rq_history(uint16_t *out, int max) {
+    uint32_t count = rq_samples < RQ_SAMPLES ? rq_samples : RQ_SAMPLES;
+    uint32_t start = rq_samples - count;
+
+    if (count > (uint32_t)max) {
+        start += count - max;
+        count = max;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = rq_history[(start + i) % RQ_SAMPLES];
+    }
+
+    return count;
+}
+
+uint32_t schedstat_rq_max(void) {
+    return rq_max;
+}
+
+void schedstat_reset(void) {
+    kmemset(sched_latencies, 0, sizeof(sched_latencies));
+    rq_samples = 0;
+    rq_max = 0;
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SCHEDSTAT_H
+#define SCHEDSTAT_H
+
+#include <stdint.h>
+#include "log2.h"
+
+// How a process became runnable, latencies are kept separately for each
+#define SCHED_WAKE_NEW     0  // Just created
+#define SCHED_WAKE_WAKEUP  1  // Woken from waiting
+#define SCHED_WAKE_PREEMPT 2  // Preempted by the tick
+#define SCHED_WAKE_YIELD   3  // Gave up the CPU but stayed runnable
+#define SCHED_NR_WAKE      4
+
+#define RQ_SAMPLES      256  // Run queue length history
+#define RQ_SAMPLE_TICKS 25   // Ticks between samples, 100 ms at HZ=250
+
+struct sched_latency {
+    uint32_t count;
+    uint64_t total;   // Cycles from runnable to running
+    uint64_t max;
+    uint32_t hist[HIST_BUCKETS];
+};
+
+struct process_control_block;
+
+// The process is runnable from now on, waiting for the CPU
+void schedstat_enqueue(struct process_control_block *pcb, int wake_class);
+
+// The scheduler picked it, record how long it waited
+void schedstat_run(struct process_control_block *pcb);
+
+// From the timer interrupt, samples the run queue length
+void schedstat_tick(void);
+
+void schedstat_latency(int wake_class, struct sched_latency *out);
+const char *schedstat_class_name(int wake_class);
+
+// Oldest first into out, returns how many samples there were
+int schedstat_rq_history(uint16_t *out, int max);
+uint32_t schedstat_rq_max(void);
+
+void schedstat_reset(void);
+
+#endif // SCHEDSTAT_H
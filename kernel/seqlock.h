@@ -0,0 +1,50 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include "compiler.h"
+#include "tsc.h"
+
+/*
+ * Sequence counter for data with one writer and many readers. The
+ * writer makes the count odd while it updates, readers retry if the
+ * count was odd or changed under them. x86 doesn't reorder loads with
+ * loads or stores with stores, so compiler barriers are enough.
+ *
+ * Everything here is always_inline so user-side code (the shared
+ * time page) can use it without calling into the kernel.
+ */
+typedef struct {
+    volatile uint32_t sequence;
+} seqcount_t;
+
+#define SEQCOUNT_INIT { 0 }
+
+static inline __attribute__((always_inline)) uint32_t read_seqcount_begin(const seqcount_t *s) {
+    uint32_t seq;
+
+    while ((seq = s->sequence) & 1)
+        cpu_relax();
+
+    barrier();
+    return seq;
+}
+
+static inline __attribute__((always_inline)) int read_seqcount_retry(const seqcount_t *s, uint32_t start) {
+    barrier();
+    return s->sequence != start;
+}
+
+static inline __attribute__((always_inline)) void write_seqcount_begin(seqcount_t *s) {
+    s->sequence++;
+    barrier();
+}
+
+static inline __attribute__((always_inline)) void write_seqcount_end(seqcount_t *s) {
+    barrier();
+    s->sequence++;
+}
+
+#endif // SEQLOCK_H
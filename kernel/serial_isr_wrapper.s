@@ -0,0 +1,19 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+.global serial_isr_wrapper
+
+serial_isr_wrapper:
+    pushal
+    cld              # C code following the sysV ABI requires DF to be clear on function entry
+    pushl $4         # IRQ4
+    call irq_enter
+    addl $4, %esp
+    call serial_isr
+    pushl $4
+    call irq_eoi
+    addl $4, %esp
+    pushl $4
+    call irq_exit
+    addl $4, %esp
+    popal
+    iret
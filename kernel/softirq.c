@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/softirq.c
+ *
+ * Deferred interrupt work.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "cputime.h"
+#include "irqflags.h"
+#include "math64.h"
+#include "percpu.h"
+#include "softirq.h"
+#include "tsc.h"
+
+static const char *softirq_names[NR_SOFTIRQS] = {
+    [TIMER_SOFTIRQ] = "timer",
+    [INPUT_SOFTIRQ] = "input",
+    [RCU_SOFTIRQ]   = "rcu",
+    [LOG_SOFTIRQ]   = "log",
+};
+
+static void (*softirq_vec[NR_SOFTIRQS])(void);
+
+uint32_t hardirq_count[NR_CPUS];
+uint32_t softirq_active[NR_CPUS];
+
+// Only touched by their own CPU with interrupts off
+static volatile uint32_t softirq_pending[NR_CPUS];
+static volatile uint32_t ksoftirqd_wakeup[NR_CPUS];
+static uint32_t softirq_counts[NR_CPUS][NR_SOFTIRQS];
+
+void open_softirq(int nr, void (*action)(void)) {
+    softirq_vec[nr] = action;
+}
+
+void raise_softirq_irqoff(int nr) {
+    int cpu = smp_processor_id();
+
+    softirq_pending[cpu] |= 1U << nr;
+
+    // Nothing on the way out of an interrupt will pick it up
+    if (!in_interrupt()) {
+        ksoftirqd_wakeup[cpu] = 1;
+    }
+}
+
+void raise_softirq(int nr) {
+    uint32_t flags;
+
+    local_irq_save(flags);
+    raise_softirq_irqoff(nr);
+    local_irq_restore(flags);
+}
+
+int local_softirq_pending(void) {
+    return softirq_pending[smp_processor_id()] != 0;
+}
+
+void do_softirq(void) {
+    int cpu = smp_processor_id();
+    int restart = MAX_SOFTIRQ_RESTART;
+    uint32_t pending, flags;
+    uint64_t end;
+
+    if (in_interrupt()) {
+        return;
+    }
+
+    local_irq_save(flags);
+
+    pending = softirq_pending[cpu];
+    if (!pending) {
+        local_irq_restore(flags);
+        return;
+    }
+
+    softirq_active[cpu] = 1;
+    cputime_enter(CPUTIME_IRQ);
+    end = rdtsc() + div_u64((uint64_t)tsc_khz * MAX_SOFTIRQ_TIME_US, 1000);
+
+    for (;;) {
+        softirq_pending[cpu] = 0;
+        local_irq_enable();
+
+        for (int nr = 0; pending; nr++, pending >>= 1) {
+            if ((pending & 1) && softirq_vec[nr]) {
+                softirq_counts[cpu][nr]++;
+                softirq_vec[nr]();
+            }
+        }
+
+        local_irq_disable();
+
+        pending = softirq_pending[cpu];
+        if (!pending) {
+            break;
+        }
+
+        // Raised again while we ran, don't let it starve everything else
+        if (!--restart || rdtsc() >= end) {
+            ksoftirqd_wakeup[cpu] = 1;
+            break;
+        }
+    }
+
+    cputime_exit();
+    softirq_active[cpu] = 0;
+
+    local_irq_restore(flags);
+}
+
+void ksoftirqd_run(void) {
+    int cpu = smp_processor_id();
+
+    if (!ksoftirqd_wakeup[cpu]) {
+        return;
+    }
+
+    ksoftirqd_wakeup[cpu] = 0;
+    do_softirq();
+}
+
+uint32_t softirq_count(int nr) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        total += softirq_counts[cpu][nr];
+    }
+
+    return total;
+}
+
+const char *softirq_name(int nr) {
+    if (nr < 0 || nr >= NR_SOFTIRQS) {
+        return "unknown";
+    }
+
+    return softirq_names[nr];
+}
@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SOFTIRQ_H
+#define SOFTIRQ_H
+
+#include <stdint.h>
+#include "percpu.h"
+
+/*
+ * Bottom halves. Interrupt handlers only talk to the device and raise
+ * one of these, the real work runs with interrupts enabled on the way
+ * out of the outermost interrupt. If they keep getting raised faster
+ * than they finish, the rest is left for the idle loop.
+ */
+enum {
+    TIMER_SOFTIRQ,  // Expire the timer wheel
+    INPUT_SOFTIRQ,  // Scancodes into the shell
+    RCU_SOFTIRQ,    // Grace period callbacks
+    LOG_SOFTIRQ,    // Kernel log out to the console and serial
+    NR_SOFTIRQS
+};
+
+#define MAX_SOFTIRQ_RESTART 10    // Passes per interrupt exit...
+#define MAX_SOFTIRQ_TIME_US 2000  // ...or this long, whichever comes first
+
+extern uint32_t hardirq_count[NR_CPUS];   // Nesting depth of irq_enter()
+extern uint32_t softirq_active[NR_CPUS];  // Running bottom halves right now
+
+static inline int in_irq(void) {
+    return hardirq_count[smp_processor_id()] != 0;
+}
+
+static inline int in_softirq(void) {
+    return softirq_active[smp_processor_id()] != 0;
+}
+
+static inline int in_interrupt(void) {
+    return in_irq() || in_softirq();
+}
+
+void open_softirq(int nr, void (*action)(void));
+
+void raise_softirq_irqoff(int nr);  // Interrupts already disabled, e.g. in a handler
+void raise_softirq(int nr);
+
+int local_softirq_pending(void);
+
+// Run whatever is pending, from irq_exit() or the idle loop
+void do_softirq(void);
+
+// Idle loop side of the deferral, runs bottom halves irq_exit() gave up on
+void ksoftirqd_run(void);
+
+uint32_t softirq_count(int nr);
+const char *softirq_name(int nr);
+
+#endif // SOFTIRQ_H
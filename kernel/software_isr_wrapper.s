@@ -3,6 +3,17 @@
 .global software_isr_wrapper
 
 software_isr_wrapper:
+    # The user's registers, put back on the way out
+    pushl %ebp
+    pushl %edi
+    pushl %esi
+    pushl %edx
+    pushl %ecx
+    pushl %ebx
+
+    # A separate copy as arguments, the callee is free to scribble on it
+    pushl %ebp       # arg6
+    pushl %edi       # arg5
     pushl %esi
     pushl %edx
     pushl %ecx
@@ -13,6 +24,12 @@ software_isr_wrapper:
 
     call software_interrupt_handler
 
-    addl $20, %esp
+    addl $28, %esp   # eax holds the return value now
+    popl %ebx
+    popl %ecx
+    popl %edx
+    popl %esi
+    popl %edi
+    popl %ebp
 
     iret
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/spinlock.c
+ *
+ * Spinlocks, ticket locks and MCS locks, plus lockstat.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "spinlock.h"
+#include "tsc.h"
+
+volatile int lockstat_enabled = 0;
+static struct lock_stat *lockstat_list = NULL;
+
+// Push a lock onto the stats list, lock-free so it can run under any lock
+static void lockstat_register(struct lock_stat *stat) {
+    if (__atomic_exchange_n(&stat->registered, 1, __ATOMIC_ACQ_REL))
+        return; // Someone beat us to it
+
+    struct lock_stat *head = __atomic_load_n(&lockstat_list, __ATOMIC_ACQUIRE);
+    do {
+        stat->next = head;
+    } while (!__atomic_compare_exchange_n(&lockstat_list, &head, stat, 0,
+                                          __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+/*
+ * Called with the lock held, so the counters are protected by the
+ * lock they describe and need no atomics of their own.
+ */
+static void lockstat_record(struct lock_stat *stat, uint64_t start) {
+    if (!stat->registered)
+        lockstat_register(stat);
+
+    stat->acquisitions++;
+
+    if (start) {
+        uint64_t waited = rdtsc() - start;
+        stat->contentions++;
+        stat->wait_cycles += waited;
+        if (waited > stat->max_wait)
+            stat->max_wait = waited;
+    }
+}
+
+struct lock_stat *lockstat_first(void) {
+    return __atomic_load_n(&lockstat_list, __ATOMIC_ACQUIRE);
+}
+
+void lockstat_reset(void) {
+    for (struct lock_stat *stat = lockstat_first(); stat; stat = stat->next) {
+        stat->acquisitions = 0;
+        stat->contentions = 0;
+        stat->wait_cycles = 0;
+        stat->max_wait = 0;
+    }
+}
+
+static void lock_stat_init(struct lock_stat *stat, const char *name) {
+    stat->name = name;
+    stat->acquisitions = 0;
+    stat->contentions = 0;
+    stat->wait_cycles = 0;
+    stat->max_wait = 0;
+    stat->registered = 0;
+    stat->next = NULL;
+}
+
+void spin_lock_init(spinlock_t *lock, const char *name) {
+    lock->locked = 0;
+    lock_stat_init(&lock->stat, name);
+}
+
+void spin_lock(spinlock_t *lock) {
+    uint64_t start = 0;
+
+    if (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE)) {
+        if (lockstat_enabled)
+            start = rdtsc();
+
+        do {
+            // Spin on a plain read so we don't bounce the cache line around
+            while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED))
+                cpu_relax();
+        } while (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE));
+    }
+
+    if (lockstat_enabled)
+        lockstat_record(&lock->stat, start);
+}
+
+int spin_trylock(spinlock_t *lock) {
+    if (__atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE))
+        return 0;
+
+    if (lockstat_enabled)
+        lockstat_record(&lock->stat, 0);
+
+    return 1;
+}
+
+void spin_unlock(spinlock_t *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+void ticket_lock_init(ticket_lock_t *lock, const char *name) {
+    lock->next = 0;
+    lock->owner = 0;
+    lock_stat_init(&lock->stat, name);
+}
+
+void ticket_lock(ticket_lock_t *lock) {
+    uint32_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_RELAXED);
+    uint64_t start = 0;
+
+    if (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+        if (lockstat_enabled)
+            start = rdtsc();
+
+        while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket)
+            cpu_relax();
+    }
+
+    if (lockstat_enabled)
+        lockstat_record(&lock->stat, start);
+}
+
+void ticket_unlock(ticket_lock_t *lock) {
+    // Only the holder writes owner, so a plain increment is enough
+    __atomic_store_n(&lock->owner, lock->owner + 1, __ATOMIC_RELEASE);
+}
+
+void mcs_lock_init(mcs_lock_t *lock, const char *name) {
+    lock->tail = NULL;
+    lock_stat_init(&lock->stat, name);
+}
+
+void mcs_lock(mcs_lock_t *lock, mcs_node_t *node) {
+    uint64_t start = 0;
+
+    node->next = NULL;
+    node->locked = 1;
+
+    mcs_node_t *prev = __atomic_exchange_n(&lock->tail, node, __ATOMIC_ACQ_REL);
+    if (prev) {
+        if (lockstat_enabled)
+            start = rdtsc();
+
+        // Queue behind the previous waiter and spin on our own node
+        __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+        while (__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+            cpu_relax();
+    }
+
+    if (lockstat_enabled)
+        lockstat_record(&lock->stat, start);
+}
+
+void mcs_unlock(mcs_lock_t *lock, mcs_node_t *node) {
+    mcs_node_t *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+    if (!next) {
+        // No known successor, try to mark the lock free
+        mcs_node_t *expected = node;
+        if (__atomic_compare_exchange_n(&lock->tail, &expected, NULL, 0,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            return;
+
+        // A waiter is mid-enqueue, wait for it to link itself in
+        while (!(next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)))
+            cpu_relax();
+    }
+
+    __atomic_store_n(&next->locked, 0, __ATOMIC_RELEASE);
+}
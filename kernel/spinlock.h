@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include <stdint.h>
+#include "irqflags.h"
+
+/*
+ * Per-lock statistics, only collected while lockstat is switched on
+ * (see the "lockstat" shell command). Locks add themselves to the
+ * global list the first time they are taken with lockstat enabled,
+ * so statically initialised locks need no registration call.
+ */
+struct lock_stat {
+    const char *name;
+    uint32_t acquisitions;   // Times the lock was taken
+    uint32_t contentions;    // Times we had to wait for it
+    uint64_t wait_cycles;    // Total TSC cycles spent waiting
+    uint64_t max_wait;       // Longest single wait in TSC cycles
+    uint32_t registered;
+    struct lock_stat *next;
+};
+
+#define LOCK_STAT_INIT(n) { .name = (n) }
+
+// Plain test-and-test-and-set spinlock, cheapest when uncontended
+typedef struct {
+    volatile uint32_t locked;
+    struct lock_stat stat;
+} spinlock_t;
+
+// FIFO ticket lock, fair under contention
+typedef struct {
+    volatile uint32_t next;   // Next ticket to hand out
+    volatile uint32_t owner;  // Ticket currently being served
+    struct lock_stat stat;
+} ticket_lock_t;
+
+// MCS queue node, one per waiter, usually on the waiter's stack
+typedef struct mcs_node {
+    struct mcs_node *volatile next;
+    volatile uint32_t locked;
+} mcs_node_t;
+
+// MCS queue lock, every waiter spins on its own node
+typedef struct {
+    mcs_node_t *volatile tail;
+    struct lock_stat stat;
+} mcs_lock_t;
+
+#define SPINLOCK_INIT(n)    { .locked = 0, .stat = LOCK_STAT_INIT(n) }
+#define TICKET_LOCK_INIT(n) { .next = 0, .owner = 0, .stat = LOCK_STAT_INIT(n) }
+#define MCS_LOCK_INIT(n)    { .tail = 0, .stat = LOCK_STAT_INIT(n) }
+
+#define DEFINE_SPINLOCK(x)    spinlock_t x = SPINLOCK_INIT(#x)
+#define DEFINE_TICKET_LOCK(x) ticket_lock_t x = TICKET_LOCK_INIT(#x)
+#define DEFINE_MCS_LOCK(x)    mcs_lock_t x = MCS_LOCK_INIT(#x)
+
+void spin_lock_init(spinlock_t *lock, const char *name);
+void spin_lock(spinlock_t *lock);
+int spin_trylock(spinlock_t *lock);
+void spin_unlock(spinlock_t *lock);
+
+void ticket_lock_init(ticket_lock_t *lock, const char *name);
+void ticket_lock(ticket_lock_t *lock);
+void ticket_unlock(ticket_lock_t *lock);
+
+void mcs_lock_init(mcs_lock_t *lock, const char *name);
+void mcs_lock(mcs_lock_t *lock, mcs_node_t *node);
+void mcs_unlock(mcs_lock_t *lock, mcs_node_t *node);
+
+// IRQ-safe variants, for data that interrupt handlers also touch
+#define spin_lock_irqsave(lock, flags) \
+    do { local_irq_save(flags); spin_lock(lock); } while (0)
+#define spin_unlock_irqrestore(lock, flags) \
+    do { spin_unlock(lock); local_irq_restore(flags); } while (0)
+
+#define ticket_lock_irqsave(lock, flags) \
+    do { local_irq_save(flags); ticket_lock(lock); } while (0)
+#define ticket_unlock_irqrestore(lock, flags) \
+    do { ticket_unlock(lock); local_irq_restore(flags); } while (0)
+
+#define mcs_lock_irqsave(lock, node, flags) \
+    do { local_irq_save(flags); mcs_lock(lock, node); } while (0)
+#define mcs_unlock_irqrestore(lock, node, flags) \
+    do { mcs_unlock(lock, node); local_irq_restore(flags); } while (0)
+
+// Lock statistics
+extern volatile int lockstat_enabled;
+struct lock_stat *lockstat_first(void);
+void lockstat_reset(void);
+
+#endif // SPINLOCK_H
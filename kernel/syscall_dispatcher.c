@@ -11,17 +11,120 @@
 #include "syscall_table.h"
 #include "syscall_numbers.h"
 #include "print.h"
+#include "trace.h"
+#include "cputime.h"
+#include "syscall_dispatcher.h"
+#include "log2.h"
+#include "percpu.h"
+#include "tsc.h"
+#include "../mm/memory.h"
 
-#define SYSCALL_TABLE_SIZE 9
+static const char *syscall_names[SYSCALL_TABLE_SIZE] = {
+    [SYS_OPEN]          = "open",
+    [SYS_WRITE]         = "write",
+    [SYS_READ]          = "read",
+    [SYS_CLOSE]         = "close",
+    [SYS_EXECV]         = "execv",
+    [SYS_YIELD]         = "yield",
+    [SYS_EXIT]          = "exit",
+    [SYS_STAT]          = "stat",
+    [SYS_TESTPUTS]      = "testputs",
+    [SYS_CLOCK_GETTIME] = "clock_gettime",
+    [SYS_NANOSLEEP]     = "nanosleep",
+    [SYS_GETRUSAGE]     = "getrusage",
+    [SYS_GETPID]        = "getpid",
+    [SYS_URING_SETUP]   = "uring_setup",
+    [SYS_URING_ENTER]   = "uring_enter",
+};
+
+// Only ever touched by their own CPU, so plain increments will do
+static struct syscall_stat syscall_stats[NR_CPUS][SYSCALL_TABLE_SIZE];
+static uint32_t syscall_invalid[NR_CPUS];
+
+static void syscall_account(int syscall_number, int ret, uint64_t cycles) {
+    struct syscall_stat *stat = &syscall_stats[smp_processor_id()][syscall_number];
+
+    stat->calls++;
+    if (ret < 0) {
+        stat->errors++;
+    }
+    stat->cycles += cycles;
+    if (cycles > stat->max_cycles) {
+        stat->max_cycles = cycles;
+    }
+    stat->hist[hist_bucket(cycles)]++;
+}
+
+void syscall_stats_sum(int syscall_number, struct syscall_stat *out) {
+    kmemset(out, 0, sizeof(*out));
+
+    if (syscall_number < 0 || syscall_number >= SYSCALL_TABLE_SIZE) {
+        return;
+    }
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct syscall_stat *stat = &syscall_stats[cpu][syscall_number];
+
+        out->calls += stat->calls;
+        out->errors += stat->errors;
+        out->cycles += stat->cycles;
+        if (stat->max_cycles > out->max_cycles) {
+            out->max_cycles = stat->max_cycles;
+        }
+        for (int i = 0; i < HIST_BUCKETS; i++) {
+            out->hist[i] += stat->hist[i];
+        }
+    }
+}
+
+uint32_t syscall_stats_invalid(void) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        total += syscall_invalid[cpu];
+    }
+
+    return total;
+}
+
+void syscall_stats_reset(void) {
+    kmemset(syscall_stats, 0, sizeof(syscall_stats));
+    kmemset(syscall_invalid, 0, sizeof(syscall_invalid));
+}
+
+const char *syscall_name(int syscall_number) {
+    if (syscall_number < 0 || syscall_number >= SYSCALL_TABLE_SIZE || !syscall_names[syscall_number]) {
+        return "unknown";
+    }
+
+    return syscall_names[syscall_number];
+}
+
+int syscall_handler(int syscall_number, void* arg1, void* arg2, void* arg3,
+                    void* arg4, void* arg5, void* arg6) {
+    int ret;
+    uint64_t start;
+
+    cputime_enter(CPUTIME_SYSTEM);
+    trace_syscall_enter(syscall_number, arg1);
 
-int syscall_handler(int syscall_number, void* arg1, void* arg2, void* arg3, void* arg4) {
     // Check if syscall_number is within valid range
-    if (syscall_number < 0 || syscall_number >= SYSCALL_TABLE_SIZE)
+    if (syscall_number < 0 || syscall_number >= SYSCALL_TABLE_SIZE) {
+        syscall_invalid[smp_processor_id()]++;
+        trace_syscall_exit(syscall_number, -1);
+        cputime_exit();
         return -1;
+    }
 
-    // Get the function pointer from the syscall_table
-    int (*handler)(void*, void*, void*, void*) = syscall_table[syscall_number];
+    // Get the function pointer from the syscall_table, it's const so no lock is needed
+    int (*handler)(void*, void*, void*, void*, void*, void*) = syscall_table[syscall_number];
 
     // Call the syscall handler with the provided arguments
-    return handler(arg1, arg2, arg3, arg4);
+    start = rdtsc();
+    ret = handler(arg1, arg2, arg3, arg4, arg5, arg6);
+    syscall_account(syscall_number, ret, rdtsc() - start);
+
+    trace_syscall_exit(syscall_number, ret);
+    cputime_exit();
+    return ret;
 }
@@ -6,7 +6,26 @@
 #include "syscall_numbers.h"
 #include <stdint.h>
 
-// Function prototype for the syscall handler
-int syscall_handler(int syscall_number, void* arg1, void* arg2, void* arg3, void* arg4);
+#include "log2.h"
+
+// Common to the int 0x80 and sysenter paths, see Documentation/syscall_abi.md
+int syscall_handler(int syscall_number, void* arg1, void* arg2, void* arg3,
+                    void* arg4, void* arg5, void* arg6);
+
+// Per syscall counters, latencies are in TSC cycles
+struct syscall_stat {
+    uint32_t calls;
+    uint32_t errors;               // Returned a negative value
+    uint64_t cycles;               // Total, for the average
+    uint64_t max_cycles;
+    uint32_t hist[HIST_BUCKETS];   // log2 latency histogram
+};
+
+// Add up every CPU's counters for one syscall
+void syscall_stats_sum(int syscall_number, struct syscall_stat *out);
+uint32_t syscall_stats_invalid(void);  // Calls with a bad number
+void syscall_stats_reset(void);
+
+const char *syscall_name(int syscall_number);
 
 #endif // SYSCALL_DISPATCHER_H
@@ -12,5 +12,13 @@
 #define SYS_EXIT             6
 #define SYS_STAT             7
 #define SYS_TESTPUTS         8
+#define SYS_CLOCK_GETTIME    9
+#define SYS_NANOSLEEP        10
+#define SYS_GETRUSAGE        11
+#define SYS_GETPID           12
+#define SYS_URING_SETUP      13
+#define SYS_URING_ENTER      14
+
+#define SYSCALL_TABLE_SIZE   15
 
 #endif // SYSCALL_NUMBERS_H
@@ -9,17 +9,24 @@
  */
 
 #include "syscall_table.h"
+#include "uring.h"
 #include "../fs/vfs/vfs.h"
 
-// Define the syscall table
-int (*syscall_table[])(void*, void*, void*, void*) = {
-    [SYS_OPEN]     = (int (*)(void*, void*, void*, void*))vfs_open,
-    [SYS_WRITE]     = (int (*)(void*, void*, void*, void*))vfs_write,
-    [SYS_READ]      = (int (*)(void*, void*, void*, void*))vfs_read,
-    [SYS_CLOSE]      = (int (*)(void*, void*, void*, void*))vfs_close,
-    [SYS_EXECV] = (int (*)(void*, void*, void*, void*))sys_execv,
-    [SYS_YIELD]          = (int (*)(void*, void*, void*, void*))sys_yield,
-    [SYS_EXIT]          = (int (*)(void*, void*, void*, void*))sys_exit,
-    [SYS_STAT]          = (int (*)(void*, void*, void*, void*))vfs_stat,
-    [SYS_TESTPUTS]      = (int (*)(void*, void*, void*, void*))sys_testputs,
+// Define the syscall table, const so nothing can swap an entry at runtime
+int (*const syscall_table[])(void*, void*, void*, void*, void*, void*) = {
+    [SYS_OPEN]     = (int (*)(void*, void*, void*, void*, void*, void*))vfs_open,
+    [SYS_WRITE]     = (int (*)(void*, void*, void*, void*, void*, void*))vfs_write,
+    [SYS_READ]      = (int (*)(void*, void*, void*, void*, void*, void*))vfs_read,
+    [SYS_CLOSE]      = (int (*)(void*, void*, void*, void*, void*, void*))vfs_close,
+    [SYS_EXECV] = (int (*)(void*, void*, void*, void*, void*, void*))sys_execv,
+    [SYS_YIELD]          = (int (*)(void*, void*, void*, void*, void*, void*))sys_yield,
+    [SYS_EXIT]          = (int (*)(void*, void*, void*, void*, void*, void*))sys_exit,
+    [SYS_STAT]          = (int (*)(void*, void*, void*, void*, void*, void*))vfs_stat,
+    [SYS_TESTPUTS]      = (int (*)(void*, void*, void*, void*, void*, void*))sys_testputs,
+    [SYS_CLOCK_GETTIME] = (int (*)(void*, void*, void*, void*, void*, void*))sys_clock_gettime,
+    [SYS_NANOSLEEP]     = (int (*)(void*, void*, void*, void*, void*, void*))sys_nanosleep,
+    [SYS_GETRUSAGE]     = (int (*)(void*, void*, void*, void*, void*, void*))sys_getrusage,
+    [SYS_GETPID]        = (int (*)(void*, void*, void*, void*, void*, void*))sys_getpid,
+    [SYS_URING_SETUP]   = (int (*)(void*, void*, void*, void*, void*, void*))sys_uring_setup,
+    [SYS_URING_ENTER]   = (int (*)(void*, void*, void*, void*, void*, void*))sys_uring_enter,
 };
@@ -9,9 +9,13 @@ void sys_testputs(const char *str, void *unused1, void *unused2, void *unused3);
 int sys_execv(void* path, void* argv, void* unused1, void* unused2);
 int sys_yield(void* unused1, void* unused2, void* unused3, void* unused4);
 int sys_exit(void* unused1, void* unused2, void* unused3, void* unused4);
+int sys_clock_gettime(void* clock_id, void* tp, void* unused1, void* unused2);
+int sys_nanosleep(void* req, void* rem, void* unused1, void* unused2);
+int sys_getrusage(void* who, void* usage, void* unused1, void* unused2);
+int sys_getpid(void* unused1, void* unused2, void* unused3, void* unused4);
 
-// Declare the syscall table
-extern int (*syscall_table[])(void*, void*, void*, void*);
+// Declare the syscall table, read-only so lookups need no locking
+extern int (*const syscall_table[])(void*, void*, void*, void*, void*, void*);
 
 void init_syscall_table();
 
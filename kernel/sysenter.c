@@ -0,0 +1,205 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/sysenter.c
+ *
+ * SYSENTER/SYSEXIT system calls, with int 0x80 as the fallback.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "boottime.h"
+#include "cpuid.h"
+#include "msr.h"
+#include "syscall_numbers.h"
+#include "sysenter.h"
+#include "tsc.h"
+#include "uring.h"
+#include "vdso.h"
+
+extern uint8_t kernel_stack[8192];  // gdt.c, also where the TSS sends int 0x80
+
+extern void sysenter_entry(void);
+extern void __kernel_vsyscall(void);
+
+int sysenter_init(void) {
+    uint32_t eax, ebx, ecx, edx;
+    uint32_t family, model, stepping;
+
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & CPUID_1_EDX_SEP) || !(edx & CPUID_1_EDX_MSR)) {
+        boot_print("No SYSENTER, system calls use int 0x80.\n");
+        return -1;
+    }
+
+    // The Pentium Pro sets SEP without actually having it
+    family = (eax >> 8) & 0xF;
+    model = (eax >> 4) & 0xF;
+    stepping = eax & 0xF;
+    if (family == 6 && model < 3 && stepping < 3) {
+        boot_print("SYSENTER is broken on this CPU, system calls use int 0x80.\n");
+        return -1;
+    }
+
+    // sysexit derives the user selectors from this: +16 is 0x1B, +24 is 0x23
+    wrmsr(MSR_IA32_SYSENTER_CS, 0x08);
+    wrmsr(MSR_IA32_SYSENTER_ESP, (uint32_t)&kernel_stack[8192 - sizeof(uint32_t)]);
+    wrmsr(MSR_IA32_SYSENTER_EIP, (uint32_t)sysenter_entry);
+
+    vdso_data.sysenter = 1;
+    boot_print("SYSENTER enabled.\n");
+
+    return 0;
+}
+
+/*
+ * Everything below runs in ring 3.
+ */
+
+static struct uring sysbench_ring __attribute__((section(".userland.data")));
+
+static inline __attribute__((always_inline))
+int syscall6_int80(uint32_t nr, uint32_t arg1, uint32_t arg2, uint32_t arg3,
+                   uint32_t arg4, uint32_t arg5, uint32_t arg6) {
+    int ret;
+
+    // ebp is the frame pointer, so it can't be an operand
+    asm volatile("pushl %%ebp\n\t"
+                 "movl %[arg6], %%ebp\n\t"
+                 "int $0x80\n\t"
+                 "popl %%ebp"
+                 : "=a"(ret)
+                 : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5), [arg6] "m"(arg6)
+                 : "memory");
+
+    return ret;
+}
+
+static inline __attribute__((always_inline))
+int syscall6_sysenter(uint32_t nr, uint32_t arg1, uint32_t arg2, uint32_t arg3,
+                      uint32_t arg4, uint32_t arg5, uint32_t arg6) {
+    int ret;
+
+    asm volatile("pushl %%ebp\n\t"
+                 "movl %[arg6], %%ebp\n\t"
+                 "call __kernel_vsyscall\n\t"
+                 "popl %%ebp"
+                 : "=a"(ret)
+                 : "a"(nr), "b"(arg1), "c"(arg2), "d"(arg3), "S"(arg4), "D"(arg5), [arg6] "m"(arg6)
+                 : "memory");
+
+    return ret;
+}
+
+int __attribute__((section(".userland"))) syscall6(uint32_t nr, uint32_t arg1, uint32_t arg2, uint32_t arg3,
+                                                   uint32_t arg4, uint32_t arg5, uint32_t arg6) {
+    if (vdso_data.sysenter) {
+        return syscall6_sysenter(nr, arg1, arg2, arg3, arg4, arg5, arg6);
+    }
+
+    return syscall6_int80(nr, arg1, arg2, arg3, arg4, arg5, arg6);
+}
+
+// Appends num in decimal, returns the new end of the string
+static inline __attribute__((always_inline)) char *sysbench_utoa(char *p, uint32_t num) {
+    char digits[10];
+    int n = 0;
+
+    do {
+        digits[n++] = '0' + num % 10;
+        num /= 10;
+    } while (num);
+
+    while (n) {
+        *p++ = digits[--n];
+    }
+
+    return p;
+}
+
+static inline __attribute__((always_inline)) char *sysbench_append(char *p, const char *str) {
+    while (*str) {
+        *p++ = *str++;
+    }
+
+    return p;
+}
+
+void __attribute__((section(".userland"))) sysbench(void) {
+    uint32_t int80, fast = 0, batched = 0;
+    uint64_t start;
+    char line[96];
+    char *p = line;
+    int ring;
+
+    start = rdtsc();
+    for (int i = 0; i < SYSBENCH_LOOPS; i++) {
+        syscall6_int80(SYS_GETPID, 0, 0, 0, 0, 0, 0);
+    }
+    int80 = (uint32_t)(rdtsc() - start) / SYSBENCH_LOOPS;
+
+    if (vdso_data.sysenter) {
+        start = rdtsc();
+        for (int i = 0; i < SYSBENCH_LOOPS; i++) {
+            syscall6_sysenter(SYS_GETPID, 0, 0, 0, 0, 0, 0);
+        }
+        fast = (uint32_t)(rdtsc() - start) / SYSBENCH_LOOPS;
+    }
+
+    // Same number of null operations, a batch per trap
+    ring = syscall6(SYS_URING_SETUP, (uint32_t)&sysbench_ring, 0, 0, 0, 0, 0);
+    if (ring >= 0) {
+        int queued = 0;
+        int i;
+
+        start = rdtsc();
+        for (i = 0; i < SYSBENCH_LOOPS; i += queued) {
+            for (queued = 0; queued < SYSBENCH_BATCH; queued++) {
+                struct uring_sqe *sqe = uring_get_sqe(&sysbench_ring, queued);
+
+                if (!sqe) {
+                    break;  // Queue's full, send what we have
+                }
+                sqe->opcode = URING_OP_NOP;
+                sqe->user_data = i + queued;
+            }
+            if (!queued) {
+                break;  // Kernel isn't taking entries, no number to give
+            }
+            uring_sq_advance(&sysbench_ring, queued);
+
+            syscall6(SYS_URING_ENTER, ring, queued, 0, 0, 0, 0);
+
+            while (uring_peek_cqe(&sysbench_ring)) {
+                uring_cqe_seen(&sysbench_ring);
+            }
+        }
+        if (i >= SYSBENCH_LOOPS) {
+            batched = (uint32_t)(rdtsc() - start) / SYSBENCH_LOOPS;
+        }
+    }
+
+    p = sysbench_append(p, "getpid round trip, int 0x80: ");
+    p = sysbench_utoa(p, int80);
+    p = sysbench_append(p, " cycles, sysenter: ");
+    if (fast) {
+        p = sysbench_utoa(p, fast);
+        p = sysbench_append(p, " cycles");
+    } else {
+        p = sysbench_append(p, "unavailable");
+    }
+    *p = '\0';
+
+    syscall6(SYS_TESTPUTS, (uint32_t)line, 0, 0, 0, 0, 0);
+
+    if (batched) {
+        p = line;
+        p = sysbench_append(p, "Batched through the rings: ");
+        p = sysbench_utoa(p, batched);
+        p = sysbench_append(p, " cycles per operation");
+        *p = '\0';
+
+        syscall6(SYS_TESTPUTS, (uint32_t)line, 0, 0, 0, 0, 0);
+    }
+}
@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef SYSENTER_H
+#define SYSENTER_H
+
+#include <stdint.h>
+
+#define SYSCALL_MAX_ARGS 6
+
+#define SYSBENCH_LOOPS 1024  // Calls timed per path by sysbench()
+#define SYSBENCH_BATCH 32    // Per uring_enter() in the batched run
+
+// Point the SYSENTER MSRs at the kernel, run on each CPU as it comes up.
+// Returns 0 if the fast path is usable, -1 if int 0x80 has to do.
+int sysenter_init(void);
+
+// User side, these live in .userland
+int syscall6(uint32_t nr, uint32_t arg1, uint32_t arg2, uint32_t arg3,
+             uint32_t arg4, uint32_t arg5, uint32_t arg6);
+void sysbench(void);  // Times null syscalls both ways and prints the result
+
+#endif // SYSENTER_H
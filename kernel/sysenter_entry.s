@@ -0,0 +1,68 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+# Fast system call entry and the user stub that goes with it. See
+# Documentation/syscall_abi.md for the register convention.
+
+.global sysenter_entry
+.global __kernel_vsyscall
+.global sysenter_return
+.extern syscall_handler
+
+.set USER_STACK_LIMIT, 0xF0000000 - 12  # USER_SIZE in gdt.c, less the three saved registers
+
+.section .text
+sysenter_entry:
+    # Interrupts are off and esp is the stack from MSR 0x175. ebp is the
+    # user stack the stub left ebp (arg6), edx (arg3) and ecx (arg2) on.
+    pushl %ds
+    pushl %es
+    pushl %ebp                   # User esp, handed back to sysexit
+
+    movw $0x10, %cx              # Kernel data segment
+    movw %cx, %ds
+    movw %cx, %es
+
+    cmpl $USER_STACK_LIMIT, %ebp # Don't follow a user stack outside user space
+    ja 1f
+
+    pushl (%ebp)                 # arg6
+    pushl %edi                   # arg5
+    pushl %esi                   # arg4
+    pushl 4(%ebp)                # arg3
+    pushl 8(%ebp)                # arg2
+    pushl %ebx                   # arg1
+    pushl %eax                   # Syscall number
+
+    cld                          # C code following the sysV ABI requires DF to be clear on function entry
+
+    call syscall_handler         # Result comes back in eax
+
+    addl $28, %esp
+    jmp 2f
+
+1:
+    movl $-1, %eax
+
+2:
+    popl %ecx                    # sysexit takes esp from ecx...
+    popl %es
+    popl %ds
+    movl $sysenter_return, %edx  # ...and eip from edx
+    sti                          # Held off until after sysexit
+    sysexit
+
+.section .userland
+# Called with eax = number and the arguments in ebx, ecx, edx, esi, edi, ebp.
+# sysenter loses ecx and edx, so they go on the stack for the kernel to read.
+__kernel_vsyscall:
+    pushl %ecx
+    pushl %edx
+    pushl %ebp
+    movl %esp, %ebp
+    sysenter
+
+sysenter_return:
+    popl %ebp
+    popl %edx
+    popl %ecx
+    ret
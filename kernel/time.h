@@ -5,6 +5,31 @@
 
 #include <stdint.h>
 
-extern volatile int32_t unix_time;
+#define HZ 250  // Scheduling ticks per second
+
+// Clock IDs for clock_gettime
+#define CLOCK_REALTIME  0
+#define CLOCK_MONOTONIC 1
+
+struct timespec {
+    int32_t tv_sec;
+    int32_t tv_nsec;
+};
+
+extern volatile int32_t unix_time;    // Wall clock seconds, updated every tick
+extern volatile uint32_t jiffies;     // Ticks since boot, wraps
+extern volatile uint64_t jiffies_64;  // Same, without the wrap
+
+// Start timekeeping on the best clocksource, wall clock seeded from the RTC
+void timekeeping_init(uint32_t boot_unix_time);
+
+// Called from the timer interrupt, HZ times per second
+void timekeeping_tick(void);
+
+uint64_t ktime_get_ns(void);       // Monotonic nanoseconds since boot
+uint64_t ktime_get_real_ns(void);  // Nanoseconds since the epoch
+uint64_t get_jiffies_64(void);
+
+const char *timekeeping_clocksource(void);
 
 #endif // TIME_H
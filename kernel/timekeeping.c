@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/timekeeping.c
+ *
+ * Monotonic and wall clock time on top of a clocksource.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "clocksource.h"
+#include "math64.h"
+#include "seqlock.h"
+#include "time.h"
+#include "vdso.h"
+
+volatile int32_t unix_time = 0;
+volatile uint32_t jiffies = 0;
+volatile uint64_t jiffies_64 = 0;
+
+/*
+ * The tick folds the cycles since cycle_last into mono_ns, so readers
+ * only ever convert a delta of about one tick. That keeps the mult/shift
+ * math well inside 64 bits and the rounding error from piling up.
+ */
+static struct {
+    seqcount_t seq;
+    struct clocksource *cs;
+    uint64_t cycle_last;
+    uint64_t mono_ns;      // Monotonic time at cycle_last
+    uint64_t real_offset;  // Realtime minus monotonic
+} tk = { .seq = SEQCOUNT_INIT };
+
+void timekeeping_init(uint32_t boot_unix_time) {
+    clocksource_init();
+
+    write_seqcount_begin(&tk.seq);
+    tk.cs = clocksource_best();
+    tk.cycle_last = tk.cs->read();
+    tk.mono_ns = 0;
+    tk.real_offset = (uint64_t)boot_unix_time * NSEC_PER_SEC;
+    write_seqcount_end(&tk.seq);
+
+    vdso_update(tk.cs, tk.cycle_last, tk.mono_ns, tk.real_offset);
+
+    unix_time = boot_unix_time;
+}
+
+void timekeeping_tick(void) {
+    write_seqcount_begin(&tk.seq);
+
+    jiffies_64++;
+    jiffies++;
+
+    if (tk.cs) {
+        uint64_t now = tk.cs->read();
+        tk.mono_ns += clocksource_cyc2ns(now - tk.cycle_last, tk.cs->mult, tk.cs->shift);
+        tk.cycle_last = now;
+    }
+
+    write_seqcount_end(&tk.seq);
+
+    vdso_update(tk.cs, tk.cycle_last, tk.mono_ns, tk.real_offset);
+
+    unix_time = (int32_t)div_u64(tk.mono_ns + tk.real_offset, NSEC_PER_SEC);
+}
+
+static uint64_t timekeeping_get_ns(uint64_t *offset) {
+    uint32_t seq;
+    uint64_t ns, off;
+
+    do {
+        seq = read_seqcount_begin(&tk.seq);
+        if (!tk.cs) {
+            return 0;
+        }
+        ns = tk.mono_ns + clocksource_cyc2ns(tk.cs->read() - tk.cycle_last,
+                                             tk.cs->mult, tk.cs->shift);
+        off = tk.real_offset;
+    } while (read_seqcount_retry(&tk.seq, seq));
+
+    if (offset) {
+        *offset = off;
+    }
+
+    return ns;
+}
+
+uint64_t ktime_get_ns(void) {
+    return timekeeping_get_ns(NULL);
+}
+
+uint64_t ktime_get_real_ns(void) {
+    uint64_t offset = 0;
+    uint64_t ns = timekeeping_get_ns(&offset);
+
+    return ns + offset;
+}
+
+uint64_t get_jiffies_64(void) {
+    uint32_t seq;
+    uint64_t ret;
+
+    do {
+        seq = read_seqcount_begin(&tk.seq);
+        ret = jiffies_64;
+    } while (read_seqcount_retry(&tk.seq, seq));
+
+    return ret;
+}
+
+const char *timekeeping_clocksource(void) {
+    return tk.cs ? tk.cs->name : "none";
+}
+
+int sys_clock_gettime(void *clock_id, void *tp, void *unused1, void *unused2) {
+    struct timespec *ts = (struct timespec *)tp;
+    uint32_t nsec;
+    uint64_t ns;
+
+    if (!ts) {
+        return -1;
+    }
+
+    switch ((uint32_t)clock_id) {
+        case CLOCK_REALTIME:
+            ns = ktime_get_real_ns();
+            break;
+        case CLOCK_MONOTONIC:
+            ns = ktime_get_ns();
+            break;
+        default:
+            return -1;
+    }
+
+    ts->tv_sec = (int32_t)div_u64_rem(ns, NSEC_PER_SEC, &nsec);
+    ts->tv_nsec = (int32_t)nsec;
+
+    return 0;
+}
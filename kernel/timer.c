@@ -0,0 +1,260 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/timer.c
+ *
+ * Hierarchical timer wheel and sleeping.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "clocksource.h"
+#include "compiler.h"
+#include "list.h"
+#include "math64.h"
+#include "process.h"
+#include "schedstat.h"
+#include "softirq.h"
+#include "spinlock.h"
+#include "syscall_table.h"
+#include "time.h"
+#include "timer.h"
+#include "wait.h"
+
+/*
+ * Five levels: the first has a slot for each of the next 256 jiffies,
+ * each level after that covers 64 times the range of the one before
+ * with 64 coarser slots. Adding and deleting a timer is a list
+ * operation on one slot. Whenever the first level wraps, the next due
+ * slot of the level above is cascaded down into the finer levels.
+ */
+#define TVN_BITS 6
+#define TVR_BITS 8
+#define TVN_SIZE (1 << TVN_BITS)
+#define TVR_SIZE (1 << TVR_BITS)
+#define TVN_MASK (TVN_SIZE - 1)
+#define TVR_MASK (TVR_SIZE - 1)
+
+static struct {
+    uint32_t timer_jiffies;  // Next jiffy to process
+    struct list_head tv1[TVR_SIZE];
+    struct list_head tv2[TVN_SIZE];
+    struct list_head tv3[TVN_SIZE];
+    struct list_head tv4[TVN_SIZE];
+    struct list_head tv5[TVN_SIZE];
+} base;
+
+static DEFINE_SPINLOCK(timer_lock);
+
+void init_timers(void) {
+    for (int i = 0; i < TVR_SIZE; i++) {
+        INIT_LIST_HEAD(&base.tv1[i]);
+    }
+
+    for (int i = 0; i < TVN_SIZE; i++) {
+        INIT_LIST_HEAD(&base.tv2[i]);
+        INIT_LIST_HEAD(&base.tv3[i]);
+        INIT_LIST_HEAD(&base.tv4[i]);
+        INIT_LIST_HEAD(&base.tv5[i]);
+    }
+
+    base.timer_jiffies = jiffies;
+
+    open_softirq(TIMER_SOFTIRQ, run_timers);
+}
+
+static void internal_add_timer(struct timer_list *timer) {
+    uint32_t expires = timer->expires;
+    uint32_t idx = expires - base.timer_jiffies;
+    struct list_head *vec;
+
+    if ((int32_t)idx < 0) {
+        // Already due, run it on the next tick
+        vec = &base.tv1[base.timer_jiffies & TVR_MASK];
+    } else if (idx < TVR_SIZE) {
+        vec = &base.tv1[expires & TVR_MASK];
+    } else if (idx < 1U << (TVR_BITS + TVN_BITS)) {
+        vec = &base.tv2[(expires >> TVR_BITS) & TVN_MASK];
+    } else if (idx < 1U << (TVR_BITS + 2 * TVN_BITS)) {
+        vec = &base.tv3[(expires >> (TVR_BITS + TVN_BITS)) & TVN_MASK];
+    } else if (idx < 1U << (TVR_BITS + 3 * TVN_BITS)) {
+        vec = &base.tv4[(expires >> (TVR_BITS + 2 * TVN_BITS)) & TVN_MASK];
+    } else {
+        vec = &base.tv5[(expires >> (TVR_BITS + 3 * TVN_BITS)) & TVN_MASK];
+    }
+
+    list_add_tail(&timer->entry, vec);
+}
+
+void timer_setup(struct timer_list *timer, void (*function)(struct timer_list *)) {
+    INIT_LIST_HEAD(&timer->entry);
+    timer->expires = 0;
+    timer->function = function;
+}
+
+int timer_pending(const struct timer_list *timer) {
+    return !list_empty(&timer->entry);
+}
+
+int mod_timer(struct timer_list *timer, uint32_t expires) {
+    uint32_t flags;
+    int pending;
+
+    spin_lock_irqsave(&timer_lock, flags);
+    pending = timer_pending(timer);
+    if (pending) {
+        list_del_init(&timer->entry);
+    }
+    timer->expires = expires;
+    internal_add_timer(timer);
+    spin_unlock_irqrestore(&timer_lock, flags);
+
+    return pending;
+}
+
+void add_timer(struct timer_list *timer) {
+    mod_timer(timer, timer->expires);
+}
+
+int del_timer(struct timer_list *timer) {
+    uint32_t flags;
+    int pending;
+
+    spin_lock_irqsave(&timer_lock, flags);
+    pending = timer_pending(timer);
+    if (pending) {
+        list_del_init(&timer->entry);
+    }
+    spin_unlock_irqrestore(&timer_lock, flags);
+
+    return pending;
+}
+
+// Re-add every timer in one coarse slot, they land in finer levels
+static int cascade(struct list_head *tv, int index) {
+    struct timer_list *timer, *tmp;
+    struct list_head list;
+
+    list_replace_init(&tv[index], &list);
+    list_for_each_entry_safe(timer, tmp, &list, entry) {
+        internal_add_timer(timer);
+    }
+
+    return index;
+}
+
+#define INDEX(n) ((base.timer_jiffies >> (TVR_BITS + (n) * TVN_BITS)) & TVN_MASK)
+
+void run_timers(void) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&timer_lock, flags);
+    while (time_after_eq(jiffies, base.timer_jiffies)) {
+        struct list_head work_list;
+        int index = base.timer_jiffies & TVR_MASK;
+
+        if (!index &&
+            !cascade(base.tv2, INDEX(0)) &&
+            !cascade(base.tv3, INDEX(1)) &&
+            !cascade(base.tv4, INDEX(2))) {
+            cascade(base.tv5, INDEX(3));
+        }
+        base.timer_jiffies++;
+
+        list_replace_init(&base.tv1[index], &work_list);
+        while (!list_empty(&work_list)) {
+            struct timer_list *timer = list_first_entry(&work_list, struct timer_list, entry);
+            void (*fn)(struct timer_list *) = timer->function;
+
+            list_del_init(&timer->entry);
+
+            // The callback may re-arm or free the timer
+            spin_unlock_irqrestore(&timer_lock, flags);
+            fn(timer);
+            spin_lock_irqsave(&timer_lock, flags);
+        }
+    }
+    spin_unlock_irqrestore(&timer_lock, flags);
+}
+
+struct sleeper {
+    struct timer_list timer;
+    pcb_t *task;  // NULL when sleeping outside any process
+    volatile int done;
+};
+
+static void process_timeout(struct timer_list *timer) {
+    struct sleeper *sleeper = container_of(timer, struct sleeper, timer);
+
+    sleeper->done = 1;
+    if (sleeper->task) {
+        wake_up_process(sleeper->task);
+    }
+}
+
+/*
+ * The caller is marked waiting so the scheduler passes it over, then
+ * halts until the timer fires and wakes it back up. Either way no
+ * cycles are spent polling.
+ */
+void schedule_timeout(uint32_t timeout) {
+    struct sleeper sleeper;
+
+    if (!timeout) {
+        return;
+    }
+
+    // Past this the wheel can't tell the expiry from the past
+    if (timeout > 0x7FFFFFFF) {
+        timeout = 0x7FFFFFFF;
+    }
+
+    sleeper.task = current_process;
+    sleeper.done = 0;
+    timer_setup(&sleeper.timer, process_timeout);
+    sleeper.timer.expires = jiffies + timeout;
+
+    // Off the run queue before the timer can fire and put it back
+    if (sleeper.task) {
+        process_wait(sleeper.task);
+    }
+    add_timer(&sleeper.timer);
+
+    wait_event(sleeper.done);
+
+    // Nothing else ran, so the scheduler never saw it come back
+    schedstat_run(sleeper.task);
+}
+
+// One extra jiffy, the current one is already partly over
+void msleep(uint32_t ms) {
+    schedule_timeout(msecs_to_jiffies(ms) + 1);
+}
+
+void usleep(uint32_t us) {
+    schedule_timeout(usecs_to_jiffies(us) + 1);
+}
+
+int sys_nanosleep(void *req, void *rem, void *unused1, void *unused2) {
+    const struct timespec *ts = (const struct timespec *)req;
+    struct timespec *left = (struct timespec *)rem;
+    uint32_t ticks;
+
+    if (!ts || ts->tv_sec < 0 || ts->tv_nsec < 0 || ts->tv_nsec >= (int32_t)NSEC_PER_SEC) {
+        return -1;
+    }
+
+    // Nothing can interrupt the sleep, so there's never time left over
+    ticks = (uint32_t)ts->tv_sec * HZ +
+            (uint32_t)div_u64((uint64_t)ts->tv_nsec * HZ + NSEC_PER_SEC - 1, NSEC_PER_SEC);
+    schedule_timeout(ticks + 1);
+
+    if (left) {
+        left->tv_sec = 0;
+        left->tv_nsec = 0;
+    }
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+#include "list.h"
+#include "math64.h"
+#include "time.h"
+
+struct timer_list {
+    struct list_head entry;              // Wheel slot, empty while not pending
+    uint32_t expires;                    // In jiffies
+    void (*function)(struct timer_list *);
+};
+
+// Compare jiffies values, correct across wraparound
+#define time_after(a, b)     ((int32_t)((b) - (a)) < 0)
+#define time_after_eq(a, b)  ((int32_t)((a) - (b)) >= 0)
+#define time_before(a, b)    time_after(b, a)
+
+static inline uint32_t msecs_to_jiffies(uint32_t ms) {
+    return (uint32_t)div_u64((uint64_t)ms * HZ + 999, 1000);
+}
+
+static inline uint32_t usecs_to_jiffies(uint32_t us) {
+    return (uint32_t)div_u64((uint64_t)us * HZ + 999999, 1000000);
+}
+
+void init_timers(void);
+
+void timer_setup(struct timer_list *timer, void (*function)(struct timer_list *));
+void add_timer(struct timer_list *timer);
+int mod_timer(struct timer_list *timer, uint32_t expires);  // 1 if it was pending
+int del_timer(struct timer_list *timer);                    // 1 if it was pending
+int timer_pending(const struct timer_list *timer);
+
+// Expire due timers, runs as TIMER_SOFTIRQ after the tick
+void run_timers(void);
+
+// Sleep the caller, at least as long as asked and without spinning
+void schedule_timeout(uint32_t timeout);
+void msleep(uint32_t ms);
+void usleep(uint32_t us);
+
+#endif // TIMER_H
@@ -0,0 +1,18 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+.global timer_isr_wrapper
+.global spurious_isr_wrapper
+
+timer_isr_wrapper:
+    pushal
+    cld              # C code following the sysV ABI requires DF to be clear on function entry
+    pushl %esp       # struct pt_regs *, the pushal frame plus what the CPU pushed
+    call timer_isr
+    addl $4, %esp
+    popal
+    iret
+
+# The local APIC doesn't expect an EOI for spurious interrupts
+spurious_isr_wrapper:
+    lock incl irq_spurious_count
+    iret
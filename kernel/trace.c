@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/trace.c
+ *
+ * Static tracepoints and the per-CPU trace rings.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "jump_label.h"
+#include "kprintf.h"
+#include "percpu.h"
+#include "string.h"
+#include "trace.h"
+#include "tsc.h"
+#include "../drivers/serial.h"
+
+DEFINE_STATIC_KEY(tp_sched_switch);
+DEFINE_STATIC_KEY(tp_syscall_enter);
+DEFINE_STATIC_KEY(tp_syscall_exit);
+DEFINE_STATIC_KEY(tp_irq_enter);
+DEFINE_STATIC_KEY(tp_irq_exit);
+DEFINE_STATIC_KEY(tp_kmalloc);
+DEFINE_STATIC_KEY(tp_kfree);
+DEFINE_STATIC_KEY(tp_vfs_open);
+DEFINE_STATIC_KEY(tp_vfs_read);
+DEFINE_STATIC_KEY(tp_vfs_write);
+
+static const struct {
+    const char *name;
+    struct static_key *key;
+} trace_events[TRACE_NR_EVENTS] = {
+    [TRACE_SCHED_SWITCH]  = { "sched_switch",  &tp_sched_switch },
+    [TRACE_SYSCALL_ENTER] = { "syscall_enter", &tp_syscall_enter },
+    [TRACE_SYSCALL_EXIT]  = { "syscall_exit",  &tp_syscall_exit },
+    [TRACE_IRQ_ENTER]     = { "irq_enter",     &tp_irq_enter },
+    [TRACE_IRQ_EXIT]      = { "irq_exit",      &tp_irq_exit },
+    [TRACE_KMALLOC]       = { "kmalloc",       &tp_kmalloc },
+    [TRACE_KFREE]         = { "kfree",         &tp_kfree },
+    [TRACE_VFS_OPEN]      = { "vfs_open",      &tp_vfs_open },
+    [TRACE_VFS_READ]      = { "vfs_read",      &tp_vfs_read },
+    [TRACE_VFS_WRITE]     = { "vfs_write",     &tp_vfs_write },
+};
+
+/*
+ * A writer claims a slot by bumping head with a locked add, so an
+ * interrupt that traces in the middle of another record just takes the
+ * next slot. Old records get overwritten once the ring wraps, the
+ * newest TRACE_RING_SIZE are what's kept.
+ */
+struct trace_ring {
+    volatile uint32_t head;  // Slots ever claimed
+    struct trace_record records[TRACE_RING_SIZE];
+};
+
+static struct trace_ring trace_rings[NR_CPUS];
+
+void trace_write(uint16_t event, uint32_t arg0, uint32_t arg1, uint32_t arg2) {
+    int cpu = smp_processor_id();
+    struct trace_ring *ring = &trace_rings[cpu];
+    uint32_t slot = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    struct trace_record *rec = &ring->records[slot & (TRACE_RING_SIZE - 1)];
+
+    rec->tsc = rdtsc();
+    rec->event = event;
+    rec->cpu = cpu;
+    rec->arg[0] = arg0;
+    rec->arg[1] = arg1;
+    rec->arg[2] = arg2;
+}
+
+int trace_set_event(const char *name, int enable) {
+    int all = my_strcmp(name, "all") == 0;
+    int found = 0;
+
+    for (int i = 0; i < TRACE_NR_EVENTS; i++) {
+        if (all || my_strcmp(name, trace_events[i].name) == 0) {
+            if (enable) {
+                static_key_enable(trace_events[i].key);
+            } else {
+                static_key_disable(trace_events[i].key);
+            }
+            found = 1;
+        }
+    }
+
+    return found ? 0 : -1;
+}
+
+const char *trace_event_name(int event) {
+    return event < TRACE_NR_EVENTS ? trace_events[event].name : "unknown";
+}
+
+int trace_event_enabled(int event) {
+    return event < TRACE_NR_EVENTS && static_key_enabled(trace_events[event].key);
+}
+
+void trace_reset(void) {
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        trace_rings[cpu].head = 0;
+    }
+}
+
+uint32_t trace_nr_records(void) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        uint32_t head = trace_rings[cpu].head;
+        total += head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+    }
+
+    return total;
+}
+
+uint32_t trace_nr_lost(void) {
+    uint32_t total = 0;
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        uint32_t head = trace_rings[cpu].head;
+        total += head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    }
+
+    return total;
+}
+
+/*
+ * Text over the wire, one record per line, numbers in hex:
+ *   E <cpu> <tsc high> <tsc low> <event> <arg0> <arg1> <arg2>
+ * The header carries the TSC rate and the event names.
+ */
+void trace_dump_serial(void) {
+    char line[96];
+
+    trace_set_event("all", 0);
+
+    ksnprintf(line, sizeof(line), "# goldspace-trace 1 tsc_khz %u\n", tsc_khz);
+    write_serial_string(line);
+    for (int i = 0; i < TRACE_NR_EVENTS; i++) {
+        ksnprintf(line, sizeof(line), "# event %d %s\n", i, trace_events[i].name);
+        write_serial_string(line);
+    }
+
+    for (int cpu = 0; cpu < NR_CPUS; cpu++) {
+        struct trace_ring *ring = &trace_rings[cpu];
+        uint32_t head = ring->head;
+        uint32_t start = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+
+        for (uint32_t i = start; i < head; i++) {
+            struct trace_record *rec = &ring->records[i & (TRACE_RING_SIZE - 1)];
+
+            ksnprintf(line, sizeof(line), "E %x %x %x %x %x %x %x\n",
+                      rec->cpu, (uint32_t)(rec->tsc >> 32), (uint32_t)rec->tsc,
+                      rec->event, rec->arg[0], rec->arg[1], rec->arg[2]);
+            write_serial_string(line);
+        }
+    }
+
+    write_serial_string("# end\n");
+}
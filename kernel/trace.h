@@ -0,0 +1,77 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "jump_label.h"
+
+enum trace_event {
+    TRACE_SCHED_SWITCH,   // prev pid, next pid
+    TRACE_SYSCALL_ENTER,  // number, arg1
+    TRACE_SYSCALL_EXIT,   // number, return value
+    TRACE_IRQ_ENTER,      // irq
+    TRACE_IRQ_EXIT,       // irq
+    TRACE_KMALLOC,        // pointer, size
+    TRACE_KFREE,          // pointer
+    TRACE_VFS_OPEN,       // fd, path
+    TRACE_VFS_READ,       // fd, size, return value
+    TRACE_VFS_WRITE,      // fd, size, return value
+    TRACE_NR_EVENTS
+};
+
+struct trace_record {
+    uint64_t tsc;
+    uint16_t event;
+    uint16_t cpu;
+    uint32_t arg[3];
+};
+
+#define TRACE_RING_SIZE 8192  // Records per CPU, a power of two
+
+// One key per event, their branch sites are nops until tracing starts
+extern struct static_key tp_sched_switch;
+extern struct static_key tp_syscall_enter;
+extern struct static_key tp_syscall_exit;
+extern struct static_key tp_irq_enter;
+extern struct static_key tp_irq_exit;
+extern struct static_key tp_kmalloc;
+extern struct static_key tp_kfree;
+extern struct static_key tp_vfs_open;
+extern struct static_key tp_vfs_read;
+extern struct static_key tp_vfs_write;
+
+void trace_write(uint16_t event, uint32_t arg0, uint32_t arg1, uint32_t arg2);
+
+#define TRACE_POINT(key, event, a0, a1, a2)                                 \
+    do {                                                                    \
+        if (static_branch_unlikely(key)) {                                  \
+            trace_write(event, (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2)); \
+        }                                                                   \
+    } while (0)
+
+#define trace_sched_switch(prev, next)  TRACE_POINT(tp_sched_switch, TRACE_SCHED_SWITCH, prev, next, 0)
+#define trace_syscall_enter(nr, arg1)   TRACE_POINT(tp_syscall_enter, TRACE_SYSCALL_ENTER, nr, arg1, 0)
+#define trace_syscall_exit(nr, ret)     TRACE_POINT(tp_syscall_exit, TRACE_SYSCALL_EXIT, nr, ret, 0)
+#define trace_irq_enter(irq)            TRACE_POINT(tp_irq_enter, TRACE_IRQ_ENTER, irq, 0, 0)
+#define trace_irq_exit(irq)             TRACE_POINT(tp_irq_exit, TRACE_IRQ_EXIT, irq, 0, 0)
+#define trace_kmalloc(ptr, size)        TRACE_POINT(tp_kmalloc, TRACE_KMALLOC, ptr, size, 0)
+#define trace_kfree(ptr)                TRACE_POINT(tp_kfree, TRACE_KFREE, ptr, 0, 0)
+#define trace_vfs_open(fd, path)        TRACE_POINT(tp_vfs_open, TRACE_VFS_OPEN, fd, path, 0)
+#define trace_vfs_read(fd, size, ret)   TRACE_POINT(tp_vfs_read, TRACE_VFS_READ, fd, size, ret)
+#define trace_vfs_write(fd, size, ret)  TRACE_POINT(tp_vfs_write, TRACE_VFS_WRITE, fd, size, ret)
+
+// Turn an event on or off by name, "all" for every event. 0 on success.
+int trace_set_event(const char *name, int enable);
+const char *trace_event_name(int event);
+int trace_event_enabled(int event);
+
+void trace_reset(void);
+uint32_t trace_nr_records(void);  // Currently held, all CPUs
+uint32_t trace_nr_lost(void);     // Overwritten before being dumped
+
+// Write the rings out on COM1 for scripts/trace2json.py, stops tracing first
+void trace_dump_serial(void);
+
+#endif // TRACE_H
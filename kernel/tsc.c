@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/tsc.c
+ *
+ * Time stamp counter calibration.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "tsc.h"
+#include "pit.h"
+#include "math64.h"
+
+uint32_t tsc_khz = 0;  // 0 until calibrated
+
+// Count TSC cycles over a PIT channel 2 window
+int tsc_calibrate(void) {
+    uint32_t loops = 0;
+
+    pit_oneshot_start(CALIBRATE_MS);
+    uint64_t start = rdtsc();
+
+    while (!pit_oneshot_expired()) {
+        if (++loops > CALIBRATE_MAX_LOOPS) {
+            return -1;
+        }
+    }
+
+    uint64_t delta = rdtsc() - start;
+    tsc_khz = (uint32_t)div_u64(delta, CALIBRATE_MS);
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef TSC_H
+#define TSC_H
+
+#include <stdint.h>
+
+// Read the time stamp counter
+static inline __attribute__((always_inline)) uint64_t rdtsc(void) {
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
+// Spin-wait hint, keeps hyperthread siblings and hypervisors happy
+static inline __attribute__((always_inline)) void cpu_relax(void) {
+    asm volatile("pause" : : : "memory");
+}
+
+extern uint32_t tsc_khz;  // TSC frequency, 0 until calibrated
+
+// Calibrate the TSC against the PIT, returns 0 on success
+int tsc_calibrate(void);
+
+#endif // TSC_H
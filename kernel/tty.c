@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/tty.c
+ *
+ * Console line discipline: echo, backspace and line assembly.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "compiler.h"
+#include "kfifo.h"
+#include "print.h"
+#include "tty.h"
+#include "wait.h"
+#include "../drivers/console.h"
+
+// Producer is the keyboard bottom half, consumer is whoever reads
+DEFINE_KFIFO(tty_fifo, TTY_BUF_SIZE);
+
+// The line being edited, only touched by the bottom half
+static char tty_line[TTY_LINE_MAX];
+static uint32_t tty_line_len;
+
+// Newlines that went into and out of tty_fifo, one side each
+static volatile uint32_t tty_lines_in;
+static volatile uint32_t tty_lines_out;
+
+static uint32_t tty_flags = TTY_ICANON | TTY_ECHO;
+static void (*tty_unthrottle)(void);
+
+static void tty_echo(char c) {
+    if (tty_flags & TTY_ECHO) {
+        print_char(c);
+        console_flush();  // Typing shouldn't wait for the flush timer
+    }
+}
+
+static void tty_commit(char c) {
+    kfifo_put(&tty_fifo, c);
+    if (c == '\n') {
+        WRITE_ONCE(tty_lines_in, tty_lines_in + 1);
+    }
+}
+
+void tty_receive_char(char c) {
+    if (!(tty_flags & TTY_ICANON)) {
+        tty_commit(c);
+        tty_echo(c);
+        return;
+    }
+
+    switch (c) {
+        case '\b':
+            if (tty_line_len > 0) {
+                tty_line_len--;
+                tty_echo('\b');
+            }
+            break;
+        case '\r':
+        case '\n':
+            // tty_can_receive() made sure all of it fits
+            for (uint32_t i = 0; i < tty_line_len; i++) {
+                tty_commit(tty_line[i]);
+            }
+            tty_commit('\n');
+            tty_line_len = 0;
+
+            if (tty_flags & TTY_ECHONL) {
+                tty_echo('\n');
+            }
+            break;
+        default:
+            if (tty_line_len < TTY_LINE_MAX) {
+                tty_line[tty_line_len++] = c;
+                tty_echo(c);
+            }
+            break;
+    }
+}
+
+int tty_can_receive(void) {
+    return kfifo_avail(&tty_fifo) > TTY_LINE_MAX;
+}
+
+void tty_throttle(void (*unthrottle)(void)) {
+    tty_unthrottle = unthrottle;
+}
+
+// Consumer side, after taking something out
+static void tty_consumed(void) {
+    void (*unthrottle)(void) = tty_unthrottle;
+
+    if (unthrottle && tty_can_receive()) {
+        tty_unthrottle = 0;
+        unthrottle();
+    }
+}
+
+char tty_getchar(void) {
+    uint8_t c;
+
+    console_flush();  // Prompt and cursor up before we sit and wait
+    wait_event(!kfifo_is_empty(&tty_fifo));
+
+    kfifo_get(&tty_fifo, &c);
+    if (c == '\n') {
+        WRITE_ONCE(tty_lines_out, tty_lines_out + 1);
+    }
+    tty_consumed();
+
+    return (char)c;
+}
+
+int tty_read_line(char *buf, int size) {
+    int len = 0;
+    char c;
+
+    if (tty_flags & TTY_ICANON) {
+        console_flush();
+        wait_event(READ_ONCE(tty_lines_in) != tty_lines_out);
+    }
+
+    // Whatever doesn't fit in buf is thrown away up to the newline
+    while ((c = tty_getchar()) != '\n') {
+        if (len < size - 1) {
+            buf[len++] = c;
+        }
+    }
+    buf[len] = '\0';
+
+    return len;
+}
+
+void tty_set_flags(uint32_t flags) {
+    tty_flags = flags;
+}
+
+uint32_t tty_get_flags(void) {
+    return tty_flags;
+}
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef TTY_H
+#define TTY_H
+
+#include <stdint.h>
+
+#define TTY_BUF_SIZE  1024  // Finished lines waiting for a reader, power of two
+#define TTY_LINE_MAX  255   // Longest line the editor will assemble
+
+// Line discipline flags
+#define TTY_ICANON 0x1  // Hand out whole lines, with backspace editing
+#define TTY_ECHO   0x2  // Echo input to the console
+#define TTY_ECHONL 0x4  // Echo the newline too, gash prints its own
+
+// From the keyboard bottom half
+void tty_receive_char(char c);
+
+// 1 if another full line fits, the keyboard holds back scancodes until it does
+int tty_can_receive(void);
+
+// Called when tty_can_receive() said no, to be kicked once there's room
+void tty_throttle(void (*unthrottle)(void));
+
+// Block until a character is available, then return it
+char tty_getchar(void);
+
+// Block for a whole line, copied without the newline and terminated. Returns its length.
+int tty_read_line(char *buf, int size);
+
+void tty_set_flags(uint32_t flags);
+uint32_t tty_get_flags(void);
+
+#endif // TTY_H
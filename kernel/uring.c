@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/uring.c
+ *
+ * Shared submission and completion rings for batched system calls.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "compiler.h"
+#include "process.h"
+#include "spinlock.h"
+#include "time.h"
+#include "timer.h"
+#include "uring.h"
+#include "wait.h"
+#include "../fs/vfs/vfs.h"
+
+struct uring_ctx {
+    struct uring *ring;             // NULL if the slot is free
+    uint32_t owner;                 // pid that set it up
+    uint32_t flags;                 // URING_SETUP_*
+    uint32_t idle;                  // Polling mode, jiffies without work before sleeping
+    uint32_t last_active;
+    struct timer_list poll_timer;
+    spinlock_t lock;                // Against the poller
+};
+
+static struct uring_ctx uring_ctxs[URING_MAX_RINGS];
+static DEFINE_SPINLOCK(uring_lock);  // Slot allocation
+
+static uint32_t uring_current_pid(void) {
+    return current_process ? current_process->pid : 0;
+}
+
+static int uring_issue(const struct uring_sqe *sqe) {
+    switch (sqe->opcode) {
+        case URING_OP_NOP:
+            return 0;
+        case URING_OP_OPEN:
+            return vfs_open((const char *)sqe->addr, sqe->len, 0, 0);
+        case URING_OP_READ:
+            return vfs_read(sqe->fd, (void *)sqe->addr, sqe->len, 0);
+        case URING_OP_WRITE:
+            return vfs_write(sqe->fd, (const void *)sqe->addr, sqe->len, 0);
+        case URING_OP_CLOSE:
+            return vfs_close(sqe->fd, 0, 0, 0);
+        case URING_OP_STAT:
+            return vfs_stat((const char *)sqe->addr, (struct stat *)sqe->arg, 0, 0);
+        default:
+            return -1;
+    }
+}
+
+// Run up to max submissions, returns how many were consumed
+static uint32_t uring_submit(struct uring_ctx *ctx, uint32_t max) {
+    struct uring *ring = ctx->ring;
+    uint32_t head, tail, done = 0;
+    uint32_t flags;
+
+    spin_lock_irqsave(&ctx->lock, flags);
+
+    head = ring->sq_head;
+    tail = READ_ONCE(ring->sq_tail);
+    barrier();  // Entries are only read after the tail that published them
+
+    while (done < max && head != tail) {
+        const struct uring_sqe *sqe = &ring->sqes[head & (URING_SQ_ENTRIES - 1)];
+        struct uring_cqe *cqe;
+
+        // Never drop a completion, leave the rest queued instead
+        if (ring->cq_tail - READ_ONCE(ring->cq_head) >= URING_CQ_ENTRIES) {
+            ring->flags |= URING_CQ_OVERFLOW;
+            break;
+        }
+
+        cqe = &ring->cqes[ring->cq_tail & (URING_CQ_ENTRIES - 1)];
+        cqe->user_data = sqe->user_data;
+        cqe->res = uring_issue(sqe);
+        cqe->flags = 0;
+
+        barrier();
+        WRITE_ONCE(ring->cq_tail, ring->cq_tail + 1);
+
+        head++;
+        done++;
+    }
+
+    if (head == tail) {
+        ring->flags &= ~URING_CQ_OVERFLOW;
+    }
+    WRITE_ONCE(ring->sq_head, head);
+
+    spin_unlock_irqrestore(&ctx->lock, flags);
+
+    return done;
+}
+
+// Polling mode, stands in for the submitting program's syscalls
+static void uring_poll(struct timer_list *timer) {
+    struct uring_ctx *ctx = container_of(timer, struct uring_ctx, poll_timer);
+
+    if (uring_submit(ctx, URING_POLL_BATCH)) {
+        ctx->last_active = jiffies;
+    } else if (time_after(jiffies, ctx->last_active + ctx->idle)) {
+        // Nothing to do for a while, stop until the program asks again
+        ctx->ring->flags |= URING_SQ_NEED_WAKEUP;
+        return;
+    }
+
+    mod_timer(timer, jiffies + 1);
+}
+
+static void uring_poll_wake(struct uring_ctx *ctx) {
+    ctx->ring->flags &= ~URING_SQ_NEED_WAKEUP;
+    ctx->last_active = jiffies;
+    mod_timer(&ctx->poll_timer, jiffies + 1);
+}
+
+int sys_uring_setup(void* ring, void* flags, void* idle_ms, void* unused1) {
+    struct uring *r = ring;
+    uint32_t lock_flags;
+    int id = -1;
+
+    if (!r || ((uint32_t)r & 7) || ((uint32_t)flags & ~URING_SETUP_SQPOLL)) {
+        return -1;
+    }
+
+    spin_lock_irqsave(&uring_lock, lock_flags);
+    for (int i = 0; i < URING_MAX_RINGS; i++) {
+        if (!uring_ctxs[i].ring) {
+            id = i;
+            break;
+        }
+    }
+
+    if (id >= 0) {
+        struct uring_ctx *ctx = &uring_ctxs[id];
+
+        r->sq_head = r->sq_tail = 0;
+        r->cq_head = r->cq_tail = 0;
+        r->flags = 0;
+
+        ctx->ring = r;
+        ctx->owner = uring_current_pid();
+        ctx->flags = (uint32_t)flags;
+        ctx->idle = msecs_to_jiffies((uint32_t)idle_ms ? (uint32_t)idle_ms : 1000);
+        spin_lock_init(&ctx->lock, "uring");
+        timer_setup(&ctx->poll_timer, uring_poll);
+
+        if (ctx->flags & URING_SETUP_SQPOLL) {
+            uring_poll_wake(ctx);
+        }
+    }
+    spin_unlock_irqrestore(&uring_lock, lock_flags);
+
+    return id;
+}
+
+// Returns how many submissions were consumed, always 0 in polling mode
+int sys_uring_enter(void* id, void* to_submit, void* min_complete, void* flags) {
+    uint32_t i = (uint32_t)id;
+    uint32_t enter_flags = (uint32_t)flags;
+    struct uring_ctx *ctx;
+    struct uring *ring;
+
+    if (i >= URING_MAX_RINGS || !uring_ctxs[i].ring || uring_ctxs[i].owner != uring_current_pid()) {
+        return -1;
+    }
+    ctx = &uring_ctxs[i];
+    ring = ctx->ring;
+
+    if (!(ctx->flags & URING_SETUP_SQPOLL)) {
+        // Everything completes before this returns, so there's never anything to wait for
+        return uring_submit(ctx, (uint32_t)to_submit);
+    }
+
+    if ((enter_flags & URING_ENTER_SQ_WAKEUP) && (ring->flags & URING_SQ_NEED_WAKEUP)) {
+        uring_poll_wake(ctx);
+    }
+
+    // The poller fills the completion ring from the tick
+    if (enter_flags & URING_ENTER_GETEVENTS) {
+        wait_event(READ_ONCE(ring->cq_tail) - READ_ONCE(ring->cq_head) >= (uint32_t)min_complete ||
+                   (ring->flags & URING_SQ_NEED_WAKEUP));
+    }
+
+    return 0;
+}
+
+void uring_release(uint32_t pid) {
+    uint32_t flags;
+
+    spin_lock_irqsave(&uring_lock, flags);
+    for (int i = 0; i < URING_MAX_RINGS; i++) {
+        if (uring_ctxs[i].ring && uring_ctxs[i].owner == pid) {
+            del_timer(&uring_ctxs[i].poll_timer);
+            uring_ctxs[i].ring = NULL;
+        }
+    }
+    spin_unlock_irqrestore(&uring_lock, flags);
+}
@@ -0,0 +1,113 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef URING_H
+#define URING_H
+
+#include <stdint.h>
+#include "compiler.h"
+
+/*
+ * Batched system calls through a pair of rings shared with the kernel.
+ * The program fills submission entries and bumps sq_tail, one
+ * uring_enter() runs all of them, and results come back on the
+ * completion ring in order. In polling mode a kernel timer drains the
+ * submission ring every tick, so a busy program never traps at all.
+ */
+
+#define URING_SQ_ENTRIES 64
+#define URING_CQ_ENTRIES 128  // Room for two full submission rings
+#define URING_MAX_RINGS  8
+#define URING_POLL_BATCH 32   // Submissions handled per tick in polling mode
+
+// Opcodes
+#define URING_OP_NOP   0
+#define URING_OP_OPEN  1  // addr = path, len = flags
+#define URING_OP_READ  2  // fd, addr = buffer, len
+#define URING_OP_WRITE 3  // fd, addr = buffer, len
+#define URING_OP_CLOSE 4  // fd
+#define URING_OP_STAT  5  // addr = path, arg = struct stat *
+
+// uring_setup() flags
+#define URING_SETUP_SQPOLL 0x1
+
+// uring_enter() flags
+#define URING_ENTER_GETEVENTS 0x1  // Wait for min_complete completions
+#define URING_ENTER_SQ_WAKEUP 0x2  // Restart an idle poller
+
+// Ring flags, set by the kernel
+#define URING_SQ_NEED_WAKEUP 0x1  // Poller went idle, enter with URING_ENTER_SQ_WAKEUP
+#define URING_CQ_OVERFLOW    0x2  // Submissions held back until completions are reaped
+
+struct uring_sqe {
+    uint8_t opcode;
+    uint8_t pad[3];
+    int32_t fd;
+    uint32_t addr;
+    uint32_t len;
+    uint32_t arg;
+    uint32_t pad2;
+    uint64_t user_data;  // Copied to the completion untouched
+};
+
+struct uring_cqe {
+    uint64_t user_data;
+    int32_t res;         // What the syscall would have returned
+    uint32_t flags;
+};
+
+// Lives in the program's memory, handed to the kernel by uring_setup()
+struct uring {
+    uint32_t sq_head;    // Kernel advances
+    uint32_t sq_tail;    // Program advances
+    uint32_t cq_head;    // Program advances
+    uint32_t cq_tail;    // Kernel advances
+    uint32_t flags;      // URING_SQ_NEED_WAKEUP etc.
+    struct uring_sqe sqes[URING_SQ_ENTRIES];
+    struct uring_cqe cqes[URING_CQ_ENTRIES];
+};
+
+// Syscalls
+int sys_uring_setup(void* ring, void* flags, void* idle_ms, void* unused1);
+int sys_uring_enter(void* id, void* to_submit, void* min_complete, void* flags);
+
+// Tear down every ring a process set up
+void uring_release(uint32_t pid);
+
+/*
+ * Program side helpers. uring_get_sqe() hands out the n-th free entry
+ * past the tail, or NULL once the submission queue is full, so check
+ * it before filling anything in. uring_sq_advance() publishes them.
+ */
+
+static inline __attribute__((always_inline)) struct uring_sqe *uring_get_sqe(struct uring *ring, uint32_t n) {
+    uint32_t tail = ring->sq_tail + n;
+
+    if (tail - READ_ONCE(ring->sq_head) >= URING_SQ_ENTRIES) {
+        return 0;  // Full
+    }
+
+    return &ring->sqes[tail & (URING_SQ_ENTRIES - 1)];
+}
+
+static inline __attribute__((always_inline)) void uring_sq_advance(struct uring *ring, uint32_t n) {
+    barrier();  // Entries before the tail that publishes them
+    WRITE_ONCE(ring->sq_tail, ring->sq_tail + n);
+}
+
+static inline __attribute__((always_inline)) struct uring_cqe *uring_peek_cqe(struct uring *ring) {
+    uint32_t head = ring->cq_head;
+
+    if (head == READ_ONCE(ring->cq_tail)) {
+        return 0;
+    }
+    barrier();
+
+    return &ring->cqes[head & (URING_CQ_ENTRIES - 1)];
+}
+
+static inline __attribute__((always_inline)) void uring_cqe_seen(struct uring *ring) {
+    barrier();  // Done with the entry before handing the slot back
+    WRITE_ONCE(ring->cq_head, ring->cq_head + 1);
+}
+
+#endif // URING_H
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * kernel/vdso.c
+ *
+ * Shared time page and the user-side clock routines that read it.
+ *
+ * Copyright (C) 2026 Goldside543
+ *
+ */
+
+#include <stdint.h>
+#include "clocksource.h"
+#include "math64.h"
+#include "seqlock.h"
+#include "syscall_numbers.h"
+#include "time.h"
+#include "tsc.h"
+#include "vdso.h"
+
+// Gets its own page at the start of the user region, see linker.ld
+struct vdso_data vdso_data __attribute__((section(".vvar"), aligned(0x1000))) = {
+    .seq = SEQCOUNT_INIT,
+    .clock_mode = VCLOCK_NONE,
+};
+
+void vdso_update(struct clocksource *cs, uint64_t cycle_last,
+                 uint64_t mono_ns, uint64_t real_offset) {
+    write_seqcount_begin(&vdso_data.seq);
+
+    vdso_data.clock_mode = cs ? cs->vclock_mode : VCLOCK_NONE;
+    if (cs) {
+        vdso_data.mult = cs->mult;
+        vdso_data.shift = cs->shift;
+    }
+    vdso_data.cycle_last = cycle_last;
+    vdso_data.mono_ns = mono_ns;
+    vdso_data.real_offset = real_offset;
+
+    write_seqcount_end(&vdso_data.seq);
+}
+
+/*
+ * Everything below runs in ring 3. It can't call into the kernel, so
+ * it only uses always_inline helpers and the data page.
+ */
+
+static int __attribute__((section(".userland"))) vdso_fallback(uint32_t clock_id, struct timespec *ts) {
+    int ret;
+
+    asm volatile("int $0x80"
+                 : "=a"(ret)
+                 : "a"(SYS_CLOCK_GETTIME), "b"(clock_id), "c"(ts), "d"(0), "S"(0)
+                 : "memory");
+
+    return ret;
+}
+
+// Returns 0 and fills in ns, or -1 if the page can't be used
+static int __attribute__((section(".userland"))) vdso_read_ns(uint32_t clock_id, uint64_t *ns) {
+    const struct vdso_data *vd = &vdso_data;
+    uint32_t seq;
+    uint64_t ret;
+
+    do {
+        seq = read_seqcount_begin(&vd->seq);
+        if (vd->clock_mode != VCLOCK_TSC) {
+            return -1;
+        }
+        ret = vd->mono_ns + clocksource_cyc2ns(rdtsc() - vd->cycle_last, vd->mult, vd->shift);
+        if (clock_id == CLOCK_REALTIME) {
+            ret += vd->real_offset;
+        }
+    } while (read_seqcount_retry(&vd->seq, seq));
+
+    *ns = ret;
+    return 0;
+}
+
+int __attribute__((section(".userland"))) vdso_clock_gettime(uint32_t clock_id, struct timespec *ts) {
+    uint32_t nsec;
+    uint64_t ns;
+
+    if (clock_id != CLOCK_REALTIME && clock_id != CLOCK_MONOTONIC) {
+        return -1;
+    }
+
+    if (vdso_read_ns(clock_id, &ns) != 0) {
+        return vdso_fallback(clock_id, ts);
+    }
+
+    ts->tv_sec = (int32_t)div_u64_rem(ns, NSEC_PER_SEC, &nsec);
+    ts->tv_nsec = (int32_t)nsec;
+
+    return 0;
+}
+
+// Cheapest way to timestamp a hot loop, no struct to split
+uint64_t __attribute__((section(".userland"))) vdso_clock_gettime_ns(uint32_t clock_id) {
+    struct timespec ts;
+    uint64_t ns;
+
+    if (vdso_read_ns(clock_id, &ns) == 0) {
+        return ns;
+    }
+
+    if (vdso_fallback(clock_id, &ts) != 0) {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + (uint32_t)ts.tv_nsec;
+}
@@ -0,0 +1,37 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef VDSO_H
+#define VDSO_H
+
+#include <stdint.h>
+#include "clocksource.h"
+#include "seqlock.h"
+#include "time.h"
+
+/*
+ * Time page shared with user space. The kernel updates it every tick
+ * under seq, user code reads it and extrapolates with rdtsc, the same
+ * way timekeeping does in the kernel.
+ */
+struct vdso_data {
+    seqcount_t seq;
+    uint32_t clock_mode;
+    uint32_t mult;
+    uint32_t shift;
+    uint64_t cycle_last;
+    uint64_t mono_ns;
+    uint64_t real_offset;
+    uint32_t sysenter;      // Set once the fast system call path is up
+};
+
+extern struct vdso_data vdso_data;
+
+// Kernel side, called by timekeeping whenever its base moves
+void vdso_update(struct clocksource *cs, uint64_t cycle_last,
+                 uint64_t mono_ns, uint64_t real_offset);
+
+// User side, these live in .userland and never trap unless they have to
+int vdso_clock_gettime(uint32_t clock_id, struct timespec *ts);
+uint64_t vdso_clock_gettime_ns(uint32_t clock_id);
+
+#endif // VDSO_H
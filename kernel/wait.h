@@ -0,0 +1,32 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef WAIT_H
+#define WAIT_H
+
+#include <stdint.h>
+#include "irqflags.h"
+#include "softirq.h"
+
+/*
+ * Wait for condition to become true without burning the CPU. Halts
+ * until the next interrupt and checks again; "sti; hlt" is atomic, so
+ * a wakeup from an interrupt between the check and the hlt can't be
+ * lost. Interrupts are restored to how they were on the way out.
+ *
+ * Not for interrupt handlers, nothing would ever set the condition.
+ * Counts as idle, so bottom halves put off under load run here.
+ */
+#define wait_event(condition)                                   \
+    do {                                                        \
+        uint32_t __wait_flags;                                  \
+        local_irq_save(__wait_flags);                           \
+        while (!(condition)) {                                  \
+            ksoftirqd_run();                                    \
+            if (condition)                                      \
+                break;                                          \
+            asm volatile("sti; hlt; cli" : : : "memory");       \
+        }                                                       \
+        local_irq_restore(__wait_flags);                        \
+    } while (0)
+
+#endif // WAIT_H
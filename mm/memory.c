@@ -11,6 +11,8 @@
 #include <stddef.h>
 #include <stdint.h>
 #include "../kernel/print.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/trace.h"
 
 #define MEMORY_POOL_SIZE (1024 * 1024)
 #define PAGE_SIZE 4096 // 4 KB pages
@@ -40,6 +42,7 @@ typedef struct block_footer {
 
 static unsigned char memory_pool[MEMORY_POOL_SIZE];
 static block_header* free_list = NULL;
+static DEFINE_TICKET_LOCK(heap_lock);  // Protects free_list and the block headers
 
 void write_footer(block_header* block) {
     block_footer* footer = (block_footer*)((uint8_t*)block + sizeof(block_header) + block->size);
@@ -73,7 +76,10 @@ void init_heap() {
 }
 
 void* kmalloc(size_t size) {
+    uint32_t flags;
     size = ALIGN(size);
+
+    ticket_lock_irqsave(&heap_lock, flags);
     block_header* current = free_list;
 
     while (current) {
@@ -95,23 +101,33 @@ void* kmalloc(size_t size) {
             }
 
             current->free = 0;
+            ticket_unlock_irqrestore(&heap_lock, flags);
+            trace_kmalloc((uint8_t*)current + sizeof(block_header), size);
             return (void*)((uint8_t*)current + sizeof(block_header));
         }
 
         current = current->next;
     }
 
+    ticket_unlock_irqrestore(&heap_lock, flags);
+    trace_kmalloc(NULL, size);
     return NULL; // Out of memory
 }
 
 void kfree(void* ptr) {
+    uint32_t flags;
     if (!ptr) return;
 
+    trace_kfree(ptr);
+
     block_header* block = (block_header*)((uint8_t*)ptr - sizeof(block_header));
 
+    ticket_lock_irqsave(&heap_lock, flags);
+
     // Check for corruption
     if (block->magic_head != MAGIC_HEAD || get_footer(block)->magic_tail != MAGIC_TAIL) {
         // Corrupted block
+        ticket_unlock_irqrestore(&heap_lock, flags);
         return;
     }
 
@@ -137,6 +153,8 @@ void kfree(void* ptr) {
     } else {
         write_footer(block);
     }
+
+    ticket_unlock_irqrestore(&heap_lock, flags);
 }
 
 void* kmemset(void* ptr, int value, size_t num) {
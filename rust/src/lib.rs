@@ -17,8 +17,10 @@
 use core::panic::PanicInfo;
 use core::arch::asm;
 
-static mut LOG_BUFFER: [u8; 1024] = [0; 1024];
-static mut LOG_INDEX: usize = 0;
+extern "C" {
+    // kernel/printk.c, copies the text into the kernel log ring
+    fn log_store(level: i32, text: *const u8, len: u32);
+}
 
 #[panic_handler]
 #[no_mangle]
@@ -37,99 +39,26 @@ pub enum LogLevel {
     Error,
 }
 
-#[no_mangle]
-pub fn log_message(level: LogLevel, message: &str) {
-    unsafe {
-        let prefix: &[u8] = match level {
-            LogLevel::Info => b"[INFO] ",
-            LogLevel::Warn => b"[WARN] ",
-            LogLevel::Error => b"[ERROR] ",
-        };
-
-        // Write the log level prefix
-        for &byte in prefix {
-            if LOG_INDEX < LOG_BUFFER.len() {
-                LOG_BUFFER[LOG_INDEX] = byte;
-                LOG_INDEX += 1;
-            }
-        }
-
-        // Write the message
-        for byte in message.as_bytes() {
-            if LOG_INDEX < LOG_BUFFER.len() {
-                LOG_BUFFER[LOG_INDEX] = *byte;
-                LOG_INDEX += 1;
-            }
-        }
-
-        // Add a newline after the message
-        if LOG_INDEX < LOG_BUFFER.len() {
-            LOG_BUFFER[LOG_INDEX] = b'\n';
-            LOG_INDEX += 1;
-        }
-        
-        // Handle buffer overflow
-        if LOG_INDEX >= LOG_BUFFER.len() {
-            LOG_INDEX = LOG_BUFFER.len() - 1; // Limit the index to prevent overflow
+impl LogLevel {
+    // Same numbers as LOG_INFO and friends in kernel/printk.h
+    fn syslog_level(&self) -> i32 {
+        match self {
+            LogLevel::Info => 6,
+            LogLevel::Warn => 4,
+            LogLevel::Error => 3,
         }
     }
 }
 
 #[no_mangle]
-pub fn get_log_buffer() -> &'static [u8] {
-    unsafe { &LOG_BUFFER[..LOG_INDEX] }
-}
-
-// Helper function to get the current time as a string (example implementation)
-#[no_mangle]
-fn get_current_time() -> &'static str {
-    "????-???-??? ??:??" // Placeholder for actual time retrieval
+pub fn log_message(level: LogLevel, message: &str) {
+    unsafe {
+        log_store(level.syslog_level(), message.as_ptr(), message.len() as u32);
+    }
 }
 
-// Add timestamp to log messages
+// Every record in the kernel log carries its own TSC timestamp now
 #[no_mangle]
 pub fn log_message_with_timestamp(level: LogLevel, message: &str) {
-    unsafe {
-        let time_stamp = get_current_time();
-        let prefix: &[u8] = match level {
-            LogLevel::Info => b"[INFO] ",
-            LogLevel::Warn => b"[WARN] ",
-            LogLevel::Error => b"[ERROR] ",
-        };
-
-        // Write the timestamp
-        for byte in time_stamp.as_bytes() {
-            if LOG_INDEX < LOG_BUFFER.len() {
-                LOG_BUFFER[LOG_INDEX] = *byte;
-                LOG_INDEX += 1;
-            }
-        }
-        
-        // Write the log level prefix
-        for &byte in prefix {
-            if LOG_INDEX < LOG_BUFFER.len() {
-                LOG_BUFFER[LOG_INDEX] = byte;
-                LOG_INDEX += 1;
-            }
-        }
-
-        // Write the message
-        for byte in message.as_bytes() {
-            if LOG_INDEX < LOG_BUFFER.len() {
-                LOG_BUFFER[LOG_INDEX] = *byte;
-                LOG_INDEX += 1;
-            }
-        }
-
-        // Add a newline after the message
-        if LOG_INDEX < LOG_BUFFER.len() {
-            LOG_BUFFER[LOG_INDEX] = b'\n';
-            LOG_INDEX += 1;
-        }
-        
-        // Handle buffer overflow
-        if LOG_INDEX >= LOG_BUFFER.len() {
-            LOG_INDEX = LOG_BUFFER.len() - 1; // Limit the index to prevent overflow
-        }
-    }
+    log_message(level, message);
 }
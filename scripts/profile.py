@@ -0,0 +1,94 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+# Turns a 'prof dump' captured from COM1 into a flat profile and folded
+# stacks, using the symbols in kernel.bin.
+#
+# Capture the serial port, e.g. qemu ... -serial file:serial.log, run
+# 'prof start 250 -g', do some work, 'prof stop', 'prof dump', then:
+#
+#   python3 scripts/profile.py kernel/kernel.bin serial.log
+#   python3 scripts/profile.py kernel/kernel.bin serial.log --folded out.folded
+#
+# The folded output feeds straight into flamegraph.pl.
+
+import argparse
+import bisect
+import subprocess
+import sys
+from collections import Counter
+
+
+def load_symbols(kernel):
+    # nm -n sorts by address, only text symbols are of interest
+    out = subprocess.run(["nm", "-n", kernel], capture_output=True, text=True, check=True).stdout
+    addrs, names = [], []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 3 or parts[1] not in "tTwW":
+            continue
+        addrs.append(int(parts[0], 16))
+        names.append(parts[2])
+    return addrs, names
+
+
+def symbolise(addr, addrs, names):
+    i = bisect.bisect_right(addrs, addr) - 1
+    if i < 0:
+        return "0x%x" % addr
+    return names[i]
+
+
+def read_samples(path):
+    samples, inside = [], False
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("# goldspace-prof"):
+                samples, inside = [], True  # Only keep the last dump
+            elif line == "# end":
+                inside = False
+            elif inside and line.startswith("S "):
+                parts = line.split()
+                user = parts[2] == "u"
+                chain = [int(x, 16) for x in parts[3:]]
+                samples.append((user, chain))
+    return samples
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Symbolise a Goldspace profile dump")
+    parser.add_argument("kernel", help="kernel.bin the samples were taken on")
+    parser.add_argument("log", help="serial capture containing 'prof dump' output")
+    parser.add_argument("--folded", help="write folded stacks here")
+    parser.add_argument("--top", type=int, default=30, help="functions to list")
+    args = parser.parse_args()
+
+    addrs, names = load_symbols(args.kernel)
+    samples = read_samples(args.log)
+    if not samples:
+        sys.exit("no samples found in %s" % args.log)
+
+    flat = Counter()
+    folded = Counter()
+    for user, chain in samples:
+        if user:
+            frames = ["[user]"]
+        else:
+            frames = [symbolise(a, addrs, names) for a in chain]
+        flat[frames[0]] += 1
+        folded[";".join(reversed(frames))] += 1
+
+    total = len(samples)
+    print("%d samples" % total)
+    print("%8s %7s  %s" % ("samples", "%", "function"))
+    for name, count in flat.most_common(args.top):
+        print("%8d %6.2f%%  %s" % (count, 100.0 * count / total, name))
+
+    if args.folded:
+        with open(args.folded, "w") as f:
+            for stack, count in sorted(folded.items()):
+                f.write("%s %d\n" % (stack, count))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,107 @@
+# SPDX-License-Identifier: GPL-2.0-only
+
+# Converts a 'trace dump' captured from COM1 into Chrome trace event
+# JSON, which chrome://tracing, Perfetto and speedscope all load.
+#
+#   python3 scripts/trace2json.py serial.log trace.json
+#
+# Syscalls and IRQs become duration slices on their CPU's track, the
+# rest show up as instant events with their arguments attached.
+
+import json
+import sys
+
+SYSCALLS = {
+    0: "open", 1: "write", 2: "read", 3: "close", 4: "execv", 5: "yield",
+    6: "exit", 7: "stat", 8: "testputs", 9: "clock_gettime", 10: "nanosleep",
+    11: "getrusage", 12: "getpid", 13: "uring_setup", 14: "uring_enter",
+}
+
+
+def signed(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def read_trace(path):
+    tsc_khz, names, records, inside = 0, {}, [], False
+    with open(path, errors="replace") as f:
+        for line in f:
+            parts = line.split()
+            if line.startswith("# goldspace-trace"):
+                tsc_khz, names, records, inside = int(parts[4]), {}, [], True
+            elif not inside:
+                continue
+            elif line.startswith("# event"):
+                names[int(parts[2])] = parts[3]
+            elif line.startswith("# end"):
+                inside = False
+            elif parts and parts[0] == "E":
+                cpu = int(parts[1], 16)
+                tsc = (int(parts[2], 16) << 32) | int(parts[3], 16)
+                event = int(parts[4], 16)
+                args = [int(x, 16) for x in parts[5:8]]
+                records.append((tsc, cpu, names.get(event, str(event)), args))
+    return tsc_khz, records
+
+
+def convert(tsc_khz, records):
+    if not records:
+        return []
+
+    records.sort(key=lambda r: r[0])
+    base = records[0][0]
+    cycles_per_us = tsc_khz / 1000.0 if tsc_khz else 1.0
+
+    events = []
+    for tsc, cpu, name, args in records:
+        ev = {"pid": 0, "tid": cpu, "ts": (tsc - base) / cycles_per_us}
+
+        if name == "syscall_enter":
+            ev.update(ph="B", name=SYSCALLS.get(args[0], "syscall %d" % args[0]),
+                      cat="syscall", args={"arg1": "0x%x" % args[1]})
+        elif name == "syscall_exit":
+            ev.update(ph="E", name=SYSCALLS.get(args[0], "syscall %d" % args[0]),
+                      cat="syscall", args={"ret": signed(args[1])})
+        elif name == "irq_enter":
+            ev.update(ph="B", name="irq %d" % args[0], cat="irq")
+        elif name == "irq_exit":
+            ev.update(ph="E", name="irq %d" % args[0], cat="irq")
+        elif name == "sched_switch":
+            ev.update(ph="i", s="t", name="switch %d -> %d" % (args[0], args[1]), cat="sched")
+        elif name == "kmalloc":
+            ev.update(ph="i", s="t", name="kmalloc", cat="mm",
+                      args={"ptr": "0x%x" % args[0], "size": args[1]})
+        elif name == "kfree":
+            ev.update(ph="i", s="t", name="kfree", cat="mm", args={"ptr": "0x%x" % args[0]})
+        elif name == "vfs_open":
+            ev.update(ph="i", s="t", name="vfs_open", cat="vfs",
+                      args={"fd": signed(args[0]), "path": "0x%x" % args[1]})
+        elif name in ("vfs_read", "vfs_write"):
+            ev.update(ph="i", s="t", name=name, cat="vfs",
+                      args={"fd": signed(args[0]), "size": args[1], "ret": signed(args[2])})
+        else:
+            ev.update(ph="i", s="t", name=name, args={"args": args})
+
+        events.append(ev)
+
+    for cpu in sorted({r[1] for r in records}):
+        events.append({"ph": "M", "pid": 0, "tid": cpu, "name": "thread_name",
+                       "args": {"name": "cpu%d" % cpu}})
+    return events
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: trace2json.py <serial log> <output.json>")
+
+    tsc_khz, records = read_trace(sys.argv[1])
+    if not records:
+        sys.exit("no trace records found in %s" % sys.argv[1])
+
+    with open(sys.argv[2], "w") as f:
+        json.dump({"traceEvents": convert(tsc_khz, records), "displayTimeUnit": "ns"}, f)
+    print("%d records written to %s" % (len(records), sys.argv[2]))
+
+
+if __name__ == "__main__":
+    main()